@@ -0,0 +1,189 @@
+#include "better_init.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Microbenchmarks, comparing `init{...}` with the alternatives.
+// Prints a JSON object to stdout on a single line, see `make bench`.
+
+
+// Expands to the preferred init list notation for the current language standard.
+#if BETTER_INIT_ALLOW_BRACES
+#define INIT(...) init{__VA_ARGS__}
+#else
+#define INIT(...) init(__VA_ARGS__)
+#endif
+
+// Set by the makefile.
+#ifndef BENCH_OPTIMIZE
+#define BENCH_OPTIMIZE "unknown"
+#endif
+
+// The largest list size to test. Long lists take a while to compile, you can lower this to iterate faster.
+#ifndef BENCH_MAX_N
+#define BENCH_MAX_N 1024
+#endif
+
+
+// Prevents the optimizer from removing the computation of `value`.
+template <typename T>
+void do_not_optimize(const T &value)
+{
+    #ifdef _MSC_VER
+    static const volatile void *sink;
+    sink = &value;
+    #else
+    asm volatile("" : : "r"(&value) : "memory");
+    #endif
+}
+
+// Element factories. `i` is a runtime value, to prevent constant folding.
+template <typename T> struct Make;
+template <> struct Make<int>
+{
+    static constexpr const char *name = "int";
+    static int make(int i) {return i;}
+};
+template <> struct Make<float>
+{
+    static constexpr const char *name = "float";
+    static float make(int i) {return float(i) * 0.5f;}
+};
+template <> struct Make<std::string>
+{
+    // Longer than the typical SSO buffer.
+    static constexpr const char *name = "std::string";
+    static std::string make(int i) {return std::string(32, char('a' + i % 26));}
+};
+template <> struct Make<std::unique_ptr<int>>
+{
+    static constexpr const char *name = "std::unique_ptr<int>";
+    static std::unique_ptr<int> make(int i) {return std::make_unique<int>(i);}
+};
+
+volatile int runtime_seed = 0;
+
+// The methods we compare. Each returns the constructed object.
+template <typename T, std::size_t ...I>
+std::vector<T> method_init(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret = INIT(Make<T>::make(seed + int(I))...);
+    return ret;
+}
+template <typename T, std::size_t ...I>
+std::vector<T> method_initializer_list(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret = {Make<T>::make(seed + int(I))...};
+    return ret;
+}
+template <typename T, std::size_t ...I>
+std::vector<T> method_emplace_back(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret;
+    ret.reserve(sizeof...(I));
+    (void)std::initializer_list<int>{(ret.emplace_back(Make<T>::make(seed + int(I))), 0)...};
+    return ret;
+}
+template <typename T, std::size_t ...I>
+std::array<T, sizeof...(I)> method_array(std::index_sequence<I...>, int seed)
+{
+    return std::array<T, sizeof...(I)>{{Make<T>::make(seed + int(I))...}};
+}
+
+// Runs `func` repeatedly, returns the average time per call in nanoseconds.
+template <typename F>
+double measure(F func)
+{
+    using clock = std::chrono::steady_clock;
+    const auto min_duration = std::chrono::milliseconds(20);
+
+    // Warm up.
+    do_not_optimize(func());
+
+    std::size_t iterations = 0;
+    auto start = clock::now();
+    auto now = start;
+    do
+    {
+        for (int i = 0; i < 16; i++)
+            do_not_optimize(func());
+        iterations += 16;
+        now = clock::now();
+    }
+    while (now - start < min_duration);
+
+    return std::chrono::duration<double, std::nano>(now - start).count() / double(iterations);
+}
+
+bool first_result = true;
+
+void print_result(const char *type, std::size_t n, const char *method, double ns)
+{
+    std::cout << (first_result ? "" : ", ") << "{\"type\": \"" << type << "\", \"n\": " << n << ", \"method\": \"" << method << "\", \"ns\": " << ns << "}";
+    first_result = false;
+}
+
+template <typename T, std::size_t N>
+void run_initializer_list(std::true_type)
+{
+    print_result(Make<T>::name, N, "initializer_list", measure([]{return method_initializer_list<T>(std::make_index_sequence<N>{}, runtime_seed);}));
+}
+template <typename T, std::size_t N>
+void run_initializer_list(std::false_type) {} // Not copyable, `std::initializer_list` doesn't work.
+
+template <typename T, std::size_t N>
+void run(std::false_type) {} // Skipped because of `BENCH_MAX_N`.
+template <typename T, std::size_t N>
+void run(std::true_type = {})
+{
+    print_result(Make<T>::name, N, "init", measure([]{return method_init<T>(std::make_index_sequence<N>{}, runtime_seed);}));
+    run_initializer_list<T, N>(std::is_copy_constructible<T>{});
+    print_result(Make<T>::name, N, "reserve+emplace_back", measure([]{return method_emplace_back<T>(std::make_index_sequence<N>{}, runtime_seed);}));
+    print_result(Make<T>::name, N, "std::array", measure([]{return method_array<T>(std::make_index_sequence<N>{}, runtime_seed);}));
+}
+
+template <typename T>
+void run_all_sizes()
+{
+    run<T, 1>();
+    run<T, 4>(std::integral_constant<bool, 4 <= BENCH_MAX_N>{});
+    run<T, 16>(std::integral_constant<bool, 16 <= BENCH_MAX_N>{});
+    run<T, 64>(std::integral_constant<bool, 64 <= BENCH_MAX_N>{});
+    run<T, 256>(std::integral_constant<bool, 256 <= BENCH_MAX_N>{});
+    run<T, 1024>(std::integral_constant<bool, 1024 <= BENCH_MAX_N>{});
+}
+
+int main()
+{
+    std::cout << "{\"compiler\": \"";
+    #if defined(__clang__)
+    std::cout << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+    #elif defined(__GNUC__)
+    std::cout << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+    #elif defined(_MSC_VER)
+    std::cout << "msvc " << _MSC_VER;
+    #endif
+    std::cout << "\", \"standard\": " << BETTER_INIT_CXX_STANDARD << ", \"stdlib\": \"";
+    #if defined(_LIBCPP_VERSION)
+    std::cout << "libc++";
+    #elif defined(__GLIBCXX__)
+    std::cout << "libstdc++";
+    #elif defined(_MSC_VER)
+    std::cout << "msvc";
+    #endif
+    std::cout << "\", \"optimize\": \"" << BENCH_OPTIMIZE << "\"";
+    std::cout << ", \"allocator_hack\": " << (BETTER_INIT_ALLOCATOR_HACK ? "true" : "false");
+
+    std::cout << ", \"results\": [";
+    run_all_sizes<int>();
+    run_all_sizes<float>();
+    run_all_sizes<std::string>();
+    run_all_sizes<std::unique_ptr<int>>();
+    std::cout << "]}\n";
+}
@@ -0,0 +1,70 @@
+#if !BENCH_MODULE
+#include "better_init.hpp"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Set by the makefile. If true, we import the module (see `better_init.cppm`) instead of including the header.
+#if BENCH_MODULE
+import better_init;
+#endif
+
+// A compile-time benchmark, see `make bench_compile` and `make bench_module`.
+// Converts `BENCH_LISTS` different lists of `BENCH_N` elements each to a few container types.
+// The elements have `BENCH_KINDS` distinct types, cycling through them in a different order in each list.
+
+
+// Expands to the preferred init list notation for the current language standard.
+// The module doesn't export the macros, but it needs C++20 anyway, so the braces always work there.
+#if BENCH_MODULE || BETTER_INIT_ALLOW_BRACES
+#define INIT(...) init{__VA_ARGS__}
+#else
+#define INIT(...) init(__VA_ARGS__)
+#endif
+
+// Set by the makefile.
+#ifndef BENCH_N
+#define BENCH_N 256
+#endif
+#ifndef BENCH_KINDS
+#define BENCH_KINDS 4
+#endif
+#ifndef BENCH_LISTS
+#define BENCH_LISTS 4
+#endif
+
+
+// An element type. Different `K`s give distinct types.
+template <int K>
+struct Kind
+{
+    long value;
+    constexpr operator long() const {return value;}
+};
+
+template <std::size_t J, std::size_t ...I>
+std::vector<long> make_vector(std::index_sequence<I...>, long seed)
+{
+    return INIT(Kind<int((I + J) % BENCH_KINDS)>{seed + long(I)}...);
+}
+template <std::size_t J, std::size_t ...I>
+std::array<long, sizeof...(I)> make_array(std::index_sequence<I...>, long seed)
+{
+    return INIT(Kind<int((I + J) % BENCH_KINDS)>{seed + long(I)}...);
+}
+
+template <std::size_t ...J>
+long run(std::index_sequence<J...>, long seed)
+{
+    long ret = 0;
+    (void)std::initializer_list<int>{(ret += make_vector<J>(std::make_index_sequence<BENCH_N>{}, seed).back() + make_array<J>(std::make_index_sequence<BENCH_N>{}, seed).back(), 0)...};
+    return ret;
+}
+
+int main(int argc, char **)
+{
+    return int(run(std::make_index_sequence<BENCH_LISTS>{}, argc) & 1);
+}
@@ -0,0 +1,261 @@
+#include "better_init.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compares the two construction strategies, with and without `BETTER_INIT_ALLOCATOR_HACK`, see `make bench_hack`.
+// This is compiled once for each, and prints a JSON object to stdout on a single line.
+// For each element type, conversion method, and list size, records the element moves and copies, the moves of the inner containers (for nested lists),
+// the heap allocations, and the time per conversion. The counters that aren't instrumented for a given case are `null`.
+// The makefile passes the number of instructions in the `convert_*` functions below as `argv[1]`, which we print as is.
+
+
+// Expands to the preferred init list notation for the current language standard.
+#if BETTER_INIT_ALLOW_BRACES
+#define INIT(...) init{__VA_ARGS__}
+#else
+#define INIT(...) init(__VA_ARGS__)
+#endif
+
+// Set by the makefile.
+#ifndef BENCH_OPTIMIZE
+#define BENCH_OPTIMIZE "unknown"
+#endif
+// Set by the makefile. False if we're compiled with `-fno-elide-constructors`.
+#ifndef BENCH_ELIDE_CONSTRUCTORS
+#define BENCH_ELIDE_CONSTRUCTORS 1
+#endif
+
+// Keeps the conversions below in their own functions, so the makefile can count their instructions.
+#ifdef _MSC_VER
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((__noinline__))
+#endif
+
+
+// Count the heap allocations.
+static std::size_t allocations = 0;
+void *operator new(std::size_t size)
+{
+    allocations++;
+    if (void *ret = std::malloc(size ? size : 1))
+        return ret;
+    throw std::bad_alloc{};
+}
+void operator delete(void *ptr) noexcept {std::free(ptr);}
+void operator delete(void *ptr, std::size_t) noexcept {std::free(ptr);}
+
+// Prevents the optimizer from removing the computation of `value`.
+template <typename T>
+void do_not_optimize(const T &value)
+{
+    #ifdef _MSC_VER
+    static const volatile void *sink;
+    sink = &value;
+    #else
+    asm volatile("" : : "r"(&value) : "memory");
+    #endif
+}
+
+// An element type that counts its moves and copies. Large enough that moving it isn't free.
+struct Counted
+{
+    static std::size_t moves;
+    static std::size_t copies;
+
+    int value;
+    char buffer[64] = {};
+
+    Counted(int value) : value(value) {}
+    Counted(const Counted &other) : value(other.value) {copies++;}
+    Counted(Counted &&other) noexcept : value(other.value) {moves++;}
+    Counted &operator=(const Counted &) = delete;
+};
+std::size_t Counted::moves = 0;
+std::size_t Counted::copies = 0;
+
+// A vector that counts its moves, for the inner containers of nested lists.
+template <typename T, typename A = std::allocator<T>>
+struct CountedVector : std::vector<T, A>
+{
+    static std::size_t moves;
+
+    using std::vector<T, A>::vector;
+    CountedVector() {}
+    CountedVector(const CountedVector &) = default;
+    CountedVector(CountedVector &&other) noexcept : std::vector<T, A>(static_cast<std::vector<T, A> &&>(other)) {moves++;}
+};
+template <typename T, typename A>
+std::size_t CountedVector<T, A>::moves = 0;
+
+// Element factories. `i` is a runtime value, to prevent constant folding.
+// `make()` returns a ready element, `source()` returns something that the element is constructed from.
+template <typename T> struct Make;
+template <> struct Make<Counted>
+{
+    static constexpr const char *name = "Counted";
+    static constexpr bool counted = true;
+    static Counted make(int i) {return Counted(i);}
+    static int source(int i) {return i;}
+};
+template <> struct Make<std::string>
+{
+    // Longer than the typical SSO buffer.
+    static constexpr const char *name = "std::string";
+    static constexpr bool counted = false;
+    static std::string make(int i) {return std::string(32, char('a' + i % 26));}
+    static const char *source(int i) {return "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz" + i % 26;}
+};
+
+// Calls `Make<T>::make()`, for `better_init::lazy()`.
+template <typename T>
+struct MakeFunc
+{
+    int i;
+    T operator()() const {return Make<T>::make(i);}
+};
+
+volatile int runtime_seed = 0;
+
+// The conversions we measure.
+// From ready elements. Moving them into the container is unavoidable, so this is the baseline.
+template <typename T, std::size_t ...I>
+BENCH_NOINLINE std::vector<T> convert_prvalues(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret = INIT(Make<T>::make(seed + int(I))...);
+    return ret;
+}
+// From other types, ideally constructing every element directly in the container.
+template <typename T, std::size_t ...I>
+BENCH_NOINLINE std::vector<T> convert_sources(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret = INIT(Make<T>::source(seed + int(I))...);
+    return ret;
+}
+// From functions returning the elements by value, which are moved unless there's copy elision or the allocator hack constructs them in place.
+template <typename T, std::size_t ...I>
+BENCH_NOINLINE std::vector<T> convert_lazy(std::index_sequence<I...>, int seed)
+{
+    std::vector<T> ret = INIT(better_init::lazy(MakeFunc<T>{seed + int(I)})...);
+    return ret;
+}
+// Nested lists, where the inner containers are moved unless they're constructed in place.
+template <typename T, std::size_t ...I>
+BENCH_NOINLINE std::vector<CountedVector<T>> convert_nested(std::index_sequence<I...>, int seed)
+{
+    std::vector<CountedVector<T>> ret = INIT(INIT(Make<T>::source(seed + int(I)), Make<T>::source(seed))...);
+    return ret;
+}
+
+// Runs `func` repeatedly, returns the average time per call in nanoseconds.
+template <typename F>
+double measure(F func)
+{
+    using clock = std::chrono::steady_clock;
+    const auto min_duration = std::chrono::milliseconds(20);
+
+    // Warm up.
+    do_not_optimize(func());
+
+    std::size_t iterations = 0;
+    auto start = clock::now();
+    auto now = start;
+    do
+    {
+        for (int i = 0; i < 16; i++)
+            do_not_optimize(func());
+        iterations += 16;
+        now = clock::now();
+    }
+    while (now - start < min_duration);
+
+    return std::chrono::duration<double, std::nano>(now - start).count() / double(iterations);
+}
+
+bool first_result = true;
+
+// Prints a counter, or `null` if it's not instrumented.
+void print_counter(const char *name, bool counted, std::size_t value)
+{
+    std::cout << ", \"" << name << "\": ";
+    if (counted)
+        std::cout << value;
+    else
+        std::cout << "null";
+}
+
+// Runs `func` once to count the moves, copies, and allocations, then measures the time.
+// `Nested` is true if `func` returns a vector of `CountedVector<T>`.
+template <typename T, bool Nested = false, typename F>
+void run(const char *method, std::size_t n, F func)
+{
+    Counted::moves = 0;
+    Counted::copies = 0;
+    CountedVector<T>::moves = 0;
+    allocations = 0;
+    do_not_optimize(func());
+    std::size_t moves = Counted::moves, copies = Counted::copies, container_moves = CountedVector<T>::moves, allocs = allocations;
+
+    double ns = measure(func);
+
+    std::cout << (first_result ? "" : ", ") << "{\"type\": \"" << Make<T>::name << "\", \"n\": " << n << ", \"method\": \"" << method << "\"";
+    print_counter("moves", Make<T>::counted, moves);
+    print_counter("copies", Make<T>::counted, copies);
+    print_counter("container_moves", Nested, container_moves);
+    std::cout << ", \"allocations\": " << allocs << ", \"ns\": " << ns << "}";
+    first_result = false;
+}
+
+template <typename T, std::size_t N>
+void run_size()
+{
+    run<T>("prvalues", N, []{return convert_prvalues<T>(std::make_index_sequence<N>{}, runtime_seed);});
+    run<T>("sources", N, []{return convert_sources<T>(std::make_index_sequence<N>{}, runtime_seed);});
+    run<T>("lazy", N, []{return convert_lazy<T>(std::make_index_sequence<N>{}, runtime_seed);});
+    run<T, true>("nested", N, []{return convert_nested<T>(std::make_index_sequence<N>{}, runtime_seed);});
+}
+
+template <typename T>
+void run_all_sizes()
+{
+    run_size<T, 4>();
+    run_size<T, 16>();
+    run_size<T, 64>();
+}
+
+int main(int argc, char **argv)
+{
+    std::cout << "{\"compiler\": \"";
+    #if defined(__clang__)
+    std::cout << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+    #elif defined(__GNUC__)
+    std::cout << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+    #elif defined(_MSC_VER)
+    std::cout << "msvc " << _MSC_VER;
+    #endif
+    std::cout << "\", \"standard\": " << BETTER_INIT_CXX_STANDARD << ", \"stdlib\": \"";
+    #if defined(_LIBCPP_VERSION)
+    std::cout << "libc++";
+    #elif defined(__GLIBCXX__)
+    std::cout << "libstdc++";
+    #elif defined(_MSC_VER)
+    std::cout << "msvc";
+    #endif
+    std::cout << "\", \"optimize\": \"" << BENCH_OPTIMIZE << "\"";
+    std::cout << ", \"allocator_hack\": " << (BETTER_INIT_ALLOCATOR_HACK ? "true" : "false");
+    std::cout << ", \"elide_constructors\": " << (BENCH_ELIDE_CONSTRUCTORS ? "true" : "false");
+    std::cout << ", \"instructions\": " << (argc > 1 ? argv[1] : "null");
+
+    std::cout << ", \"results\": [";
+    run_all_sizes<Counted>();
+    run_all_sizes<std::string>();
+    std::cout << "]}\n";
+}
@@ -0,0 +1,31 @@
+// A C++20 module interface for `better_init.hpp`: `import better_init;`.
+// This is the same library, just parsed once per build instead of once per translation unit. The header keeps working, e.g. for older standards.
+//
+// The configuration macros (see the header) can't be passed through `import`, so they are applied when this file is compiled:
+// either define them on the command line, or put them into the config file (see `BETTER_INIT_CONFIG`), which is included below.
+// Everything that depends on them (the allocator hack, `BETTER_INIT_HOOK`, and so on) is then fixed for all importers.
+// Importers don't get the macros themselves. Note that `init{...}` requires `BETTER_INIT_ALLOW_BRACES`, which is always true in C++20.
+
+module;
+
+// The standard headers that `better_init.hpp` needs. They must be in the global module fragment rather than exported from our module,
+// so we include them here first, and then their include guards make the header's own `#include`s no-ops.
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#if __has_include(<flat_map>) && __has_include(<flat_set>) && __cplusplus > 202002L
+#include <flat_map>
+#include <flat_set>
+#endif
+
+export module better_init;
+
+// We export the whole header, including `better_init::detail`, because the templates in it refer to each other anyway.
+// The customization points in `better_init::custom` can be specialized for your own types after importing the module.
+export extern "C++"
+{
+    #include "better_init.hpp"
+}
@@ -37,11 +37,26 @@
 // All of those can be worked around by specializing `better_init::custom::??` for your container.
 // * Must have a `::value_type` typedef with the element type ()
 // * Must have a constructor from two iterators.
+// Fixed-size aggregates, such as `std::array`, are supported as well. See `better_init::custom::array_size`.
 
 namespace better_init
 {
+    // Events reported to `BETTER_INIT_HOOK`, for instrumentation.
+    enum class hook_event
+    {
+        construct_container, // `custom::construct` constructs a container `T` from a list. Reported by the default implementation.
+        allocator_hack,      // The allocator of a container `T` is substituted, see `BETTER_INIT_ALLOCATOR_HACK`. This is followed by `construct_container`.
+        convert_elem,        // An element is converted to `T` by `operator T` of our references.
+        allocator_construct, // An element `T` is constructed in place by the allocator hack, bypassing `operator T`.
+        dispatch,            // An element is processed through a function pointer table (as `T`, or the function object type `T`), because the list has several element types.
+    };
+
     namespace detail
     {
+        // Calls `BETTER_INIT_HOOK(event, T)`. Defined below, after the config file is included.
+        template <hook_event E, typename T>
+        constexpr void hook() noexcept;
+
         // Convertible to any `std::initializer_list<??>`.
         struct any_init_list
         {
@@ -52,11 +67,32 @@ namespace better_init
         // Don't want to include extra headers, so I roll my own typedefs.
         using size_t = decltype(sizeof(int));
         using ptrdiff_t = decltype((int *)nullptr - (int *)nullptr);
-        using uintptr_t = size_t;
-        static_assert(sizeof(uintptr_t) == sizeof(void *), "Internal error: Incorrect `uintptr_t` typedef, fix it.");
 
         template <typename T>
         T &&declval() noexcept; // Not defined.
+
+        // Don't want to include extra headers for `std::void_t`, and it's C++17 anyway.
+        template <typename ...P>
+        struct make_void {using type = void;};
+        template <typename ...P>
+        using void_t = typename make_void<P...>::type;
+
+        // The default implementation of `custom::element_type`. SFINAE-friendly.
+        template <typename T, typename = void>
+        struct default_element_type {};
+        template <typename T>
+        struct default_element_type<T, void_t<typename T::value_type>> {using type = typename T::value_type;};
+
+        // The default implementations of `custom::allow_implicit_init`, `custom::array_size`, and `custom::allocation_size`. Defined below.
+        template <typename T, typename = void>
+        struct default_allow_implicit_init;
+        template <typename T, typename = void>
+        struct default_array_size;
+        template <typename T, size_t N, typename = void>
+        struct default_allocation_size;
+        // The default implementation of `custom::construct`. Defined below.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct default_construct;
     }
 
     // Customization points.
@@ -64,26 +100,86 @@ namespace better_init
     {
         // Whether to make the conversion operator of `init{...}` implicit.
         // `T` is the target container type.
+        // Defaults to true if `T` has a `std::initializer_list` constructor, or is a fixed-size aggregate (see `array_size` below).
         template <typename T, typename = void>
-        struct allow_implicit_init : std::is_constructible<T, detail::any_init_list> {};
+        struct allow_implicit_init : detail::default_allow_implicit_init<T> {};
+
+        // If `T` is a fixed-size aggregate (such as `std::array`), this should inherit from `std::integral_constant<size_t, N>`, where `N` is the number of elements.
+        // Such types are initialized as `T{elems...}`, constructing each element in place. They must also have a `custom::element_type`.
+        // Defaults to detecting `std::array`-like templates: `A<E, N>` with `A<E, N>::value_type == E`, that are aggregates.
+        template <typename T, typename = void>
+        struct array_size : detail::default_array_size<T> {};
 
         // Because of a MSVC quirk (bug, probably?) we can't use a templated `operator T` for our range elements,
         // and must know exactly what we're converting to.
+        // Defaults to `T::value_type`. If you specialize this, please keep it SFINAE-friendly, e.g. only define `type` if `T` is a container.
         template <typename T, typename = void>
-        struct element_type {using type = typename T::value_type;};
+        struct element_type : detail::default_element_type<T> {};
+
+        // How many bytes constructing `T` from a list of `N` elements requests from its allocator for its own element storage. This is reported by `init{...}.allocation_size<T>`.
+        // Allocations made by the elements themselves aren't included, e.g. by `std::pmr::string`s in a `std::pmr::vector`, or by the inner containers of nested lists.
+        // This should inherit from `std::integral_constant<size_t, ...>`, or have no `value` if it's not known in advance.
+        // Defaults to `N * sizeof(element_type)` for vector-like containers (with `.data()`, `.reserve()`, and `.emplace_back()`), which we construct with a single allocation.
+        // Note that this doesn't include any padding your memory resource might need for alignment.
+        template <typename T, detail::size_t N, typename = void>
+        struct allocation_size : detail::default_allocation_size<T, N> {};
+
+        // How to replace the allocator of a container `T`. This is used by the allocator hack, see `BETTER_INIT_ALLOCATOR_HACK`.
+        // By default we look for allocators among the template arguments of `T`. This works for templates with only type parameters,
+        // and for a type, a constant, then more types (such as `small_vector<T, N, Alloc>`).
+        // Otherwise, specialize this with `using allocator_type = ...;` and `template <typename A> using rebind = ...;`,
+        // where `rebind<A>` is `T` with its allocator replaced with `A`. Both must have the same layout.
+        template <typename T, typename = void>
+        struct rebind_allocator {};
+
+        // How to insert a pair of iterators into an existing container `T`, before `pos`. Defaults to `container.insert(pos, begin, end)`.
+        // This is used by `better_init::insert()` and `better_init::append()`.
+        template <typename Void, typename T, typename Iter, typename Pos>
+        struct insert
+        {
+            template <typename TT = T>
+            constexpr auto operator()(TT &container, Pos pos, Iter begin, Iter end) const -> decltype(container.insert(static_cast<Pos &&>(pos), static_cast<Iter &&>(begin), static_cast<Iter &&>(end)))
+            {
+                return container.insert(static_cast<Pos &&>(pos), static_cast<Iter &&>(begin), static_cast<Iter &&>(end));
+            }
+        };
+
+        // An alternative to `insert` above, used by `better_init::append()`, for containers that want to know the number of elements at compile time,
+        // e.g. concurrent queues, which can then claim all `N` slots with a single atomic operation, construct the elements in place, and publish them once.
+        // If you specialize this and make `operator()(T &container, Factory factory)` valid, it's used instead of `insert`. Its result is returned from `append()`.
+        // `factory` is the same as for `construct_sized` below.
+        template <typename Void, typename T, detail::size_t N, typename Factory>
+        struct append_sized {};
+
+        // An alternative to `construct` below, for containers that want to know the number of elements at compile time.
+        // If you specialize this and make `operator()(Factory factory, P &&... extra)` valid (returning `T`), it's used instead of `construct`.
+        // `N` is the number of elements. `factory(i)` for `i` in `[0, N)` returns an object convertible to `element_type<T>`, which constructs the `i`-th element.
+        // Use each index at most once, and preferably construct the elements directly in their final location, e.g. `::new(ptr) E(factory(i))`.
+        // `extra...` are the same as for `construct`.
+        template <typename Void, typename T, detail::size_t N, typename Factory, typename ...P>
+        struct construct_sized {};
 
         // How to construct `T` from a pair of iterators. Defaults to `T(begin, end, extra...)`.
         // Where `extra...` are the arguments passed to `.to<T>(...)`, or empty for a conversion operator.
+        // Some containers are constructed differently by default (using `construct_sized`, or by emplacing the elements one by one), see `detail::default_construct`.
+        // That's decided in the primary template, so your specializations of this template don't clash with ours.
         template <typename Void, typename T, typename Iter, typename ...P>
         struct construct
         {
-            template <typename TT = T, std::enable_if_t<std::is_constructible<TT, Iter, Iter, P...>::value, int> = 0>
-            constexpr T operator()(Iter begin, Iter end, P &&... params) const noexcept(std::is_nothrow_constructible<T, Iter, Iter, P...>::value)
+            template <typename TT = T, typename = decltype(detail::default_construct<void, TT, Iter, P...>{}(detail::declval<Iter &&>(), detail::declval<Iter &&>(), detail::declval<P &&>()...))>
+            constexpr T operator()(Iter begin, Iter end, P &&... params) const
+            noexcept(noexcept(detail::default_construct<void, T, Iter, P...>{}(detail::declval<Iter &&>(), detail::declval<Iter &&>(), detail::declval<P &&>()...)))
             {
                 // Don't want to include `<utility>` for `std::move` or `std::forward`.
-                return T(static_cast<Iter &&>(begin), static_cast<Iter &&>(end), static_cast<P &&>(params)...);
+                return detail::default_construct<void, T, Iter, P...>{}(static_cast<Iter &&>(begin), static_cast<Iter &&>(end), static_cast<P &&>(params)...);
             }
         };
+
+        // How to construct `T` from a pair of iterators over elements that are already sorted, for `.to<T>(better_init::sorted, extra...)`.
+        // Make `operator()(Iter begin, Iter end, P &&... extra)` valid (returning `T`) to support a container.
+        // We specialize this for containers with `.emplace_hint()`, and for the C++23 flat containers (see `BETTER_INIT_FLAT_CONTAINERS`).
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct construct_sorted {};
     }
 }
 
@@ -105,7 +201,9 @@ namespace better_init
 #endif
 // Then, the actual version number.
 #ifndef BETTER_INIT_CXX_STANDARD
-#if BETTER_INIT_CXX_STANDARD_DATE >= 202002
+#if BETTER_INIT_CXX_STANDARD_DATE > 202002
+#define BETTER_INIT_CXX_STANDARD 23
+#elif BETTER_INIT_CXX_STANDARD_DATE >= 202002
 #define BETTER_INIT_CXX_STANDARD 20
 #elif BETTER_INIT_CXX_STANDARD_DATE >= 201703
 #define BETTER_INIT_CXX_STANDARD 17
@@ -136,7 +234,24 @@ namespace better_init
 #define BETTER_INIT_SMART_ITERATOR_TRAITS 0
 #endif
 #endif
-#if !BETTER_INIT_SMART_ITERATOR_TRAITS
+
+// Whether our iterators should return `Reference`s by value (i.e. be "proxy iterators"), instead of pointing to an array of `Reference`s.
+// This removes that array from the stack, along with the loop that fills it. The iterators then store a pointer to the elements and a position.
+// The C++20 iterator concepts are fine with this, but formally we no longer satisfy `LegacyForwardIterator`, which wants `*` to return an actual reference.
+// (Like `std::vector<bool>::iterator`.) The standard containers don't care in practice.
+// Requires mandatory copy elision, since `Reference` is non-copyable.
+#ifndef BETTER_INIT_PROXY_ITERATORS
+#if BETTER_INIT_CXX_STANDARD >= 20
+#define BETTER_INIT_PROXY_ITERATORS 1
+#else
+#define BETTER_INIT_PROXY_ITERATORS 0
+#endif
+#endif
+#if BETTER_INIT_PROXY_ITERATORS && !BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+#error `BETTER_INIT_PROXY_ITERATORS` requires mandatory copy elision.
+#endif
+
+#if !BETTER_INIT_SMART_ITERATOR_TRAITS || BETTER_INIT_PROXY_ITERATORS
 #include <iterator>
 #endif
 
@@ -187,6 +302,71 @@ namespace better_init
 #include <memory> // For `std::allocator_traits`.
 #endif
 
+// Whether to support `.to<T>(better_init::parallel(executor))`, which constructs the elements concurrently.
+// This needs a few more headers, and exceptions (if enabled) to be propagated across threads.
+#ifndef BETTER_INIT_PARALLEL
+#define BETTER_INIT_PARALLEL 1
+#endif
+#if BETTER_INIT_PARALLEL
+#include <exception> // For `std::exception_ptr`.
+#include <iterator> // For `std::move_iterator`.
+#include <memory> // For `std::allocator`.
+#endif
+
+// If true, converting a list copies a non-const lvalue element of a non-trivially-copyable type, emits a deprecation warning.
+// Use `init{...}.moved()` to move such elements instead, or pass them as const to copy them on purpose. Note that this also fires when no copy is made,
+// e.g. when constructing `std::string_view`s from `std::string`s.
+#ifndef BETTER_INIT_WARN_LVALUE_COPIES
+#define BETTER_INIT_WARN_LVALUE_COPIES 0
+#endif
+
+// Whether lists of prvalues of the same trivially copyable type store copies of them contiguously, instead of pointers to them.
+// Then the containers are constructed from a pair of pointers, which lets them copy all elements at once (usually with `memcpy`).
+#ifndef BETTER_INIT_PACK_TRIVIAL_ELEMENTS
+#define BETTER_INIT_PACK_TRIVIAL_ELEMENTS 1
+#endif
+
+// Lists with several element types and at most this many elements are processed by a pack expansion when emplacing the elements one by one
+// (e.g. into `std::vector`), so each element gets a direct call. Longer lists use a loop over a function pointer table, which compiles faster
+// and produces less code, but costs an indirect call per element (which the optimizer usually can't remove).
+#ifndef BETTER_INIT_UNROLL_LIMIT
+#define BETTER_INIT_UNROLL_LIMIT 64
+#endif
+
+#include <new> // For the placement `new`, in `better_init::uninitialized_construct()` and elsewhere.
+
+// Whether `.to<T>(better_init::sorted)` supports the C++23 flat containers (`std::flat_map` and others), by passing `std::sorted_unique` or `std::sorted_equivalent` to them.
+// This includes `<flat_map>` and `<flat_set>`, so you might want to disable it if you don't use them.
+#ifndef BETTER_INIT_FLAT_CONTAINERS
+#if BETTER_INIT_CXX_STANDARD >= 23 && __has_include(<flat_map>) && __has_include(<flat_set>)
+#define BETTER_INIT_FLAT_CONTAINERS 1
+#else
+#define BETTER_INIT_FLAT_CONTAINERS 0
+#endif
+#endif
+#if BETTER_INIT_FLAT_CONTAINERS
+#include <flat_map>
+#include <flat_set>
+#endif
+
+// Whether `.to<T>(better_init::sorted)` checks that the elements are actually sorted, and stops the program with `BETTER_INIT_ABORT` if they aren't.
+// Enabled unless `NDEBUG` is defined.
+#ifndef BETTER_INIT_CHECK_SORTED
+#ifdef NDEBUG
+#define BETTER_INIT_CHECK_SORTED 0
+#else
+#define BETTER_INIT_CHECK_SORTED 1
+#endif
+#endif
+
+// Instrumentation. If defined, this is expanded at the points listed in `better_init::hook_event`, as a statement.
+// `event` is a `better_init::hook_event` constant (usable as a template argument), `...` is the type it applies to.
+// E.g. `#define BETTER_INIT_HOOK(event, ...) my_profiler::count<event, __VA_ARGS__>()`.
+// The hooks are called from `constexpr` functions, so if yours isn't `constexpr`, lists can no longer be converted in constant expressions.
+#ifndef BETTER_INIT_HOOK
+#define BETTER_INIT_HOOK(event, ...)
+#endif
+
 // When the allocator hack is used, we need a 'may alias' attribute to `reinterpret_cast` safely.
 #ifndef BETTER_INIT_ALLOCATOR_HACK_MAY_ALIAS
 #ifdef _MSC_VER
@@ -199,8 +379,43 @@ namespace better_init
 
 namespace better_init
 {
+    // An element that is computed by calling `func()` when the container constructs it, see `better_init::lazy()`.
+    template <typename F>
+    struct lazy_t
+    {
+        F func;
+
+        using result_type = decltype(detail::declval<const F &>()());
+
+        // This is used only when the element itself is forwarded to the constructor of `T`, which happens in `.emplace_back()` and such if `T` is `result_type`.
+        // Otherwise we call `func()` directly, see `detail::make_from_elem()` and `detail::lazy_emplace_arg()`.
+        constexpr operator result_type() const noexcept(noexcept(detail::declval<const F &>()()))
+        {
+            return func();
+        }
+    };
+
+    // `init{better_init::lazy(func), ...}` adds an element that is the result of `func()`. It's called only when the container constructs this element.
+    // If `func()` returns the element type by value, the element is constructed directly in the container (in C++17 and newer), without moves.
+    // This helps with types that are expensive to move, such as ones with large inline buffers.
+    template <typename F>
+    constexpr lazy_t<std::decay_t<F>> lazy(F &&func)
+    {
+        return {static_cast<F &&>(func)};
+    }
+
+    // An element that is constructed from several arguments, see `better_init::args()`. Defined below.
+    template <typename ...P>
+    class args_t;
+
     namespace detail
     {
+        template <hook_event E, typename T>
+        constexpr void hook() noexcept
+        {
+            BETTER_INIT_HOOK(E, T);
+        }
+
         struct empty {};
 
         [[noreturn]] inline void abort() {BETTER_INIT_ABORT}
@@ -229,27 +444,456 @@ namespace better_init
             return false;
         }
 
+        // Whether all types in `P...` are the same. True for empty packs.
+        template <typename ...P>
+        struct all_same : std::true_type {};
+        template <typename T, typename ...P>
+        struct all_same<T, P...> : std::integral_constant<bool, all_of({std::is_same<T, P>::value...})> {};
+
+        // The first type in a non-empty pack.
+        template <typename T, typename ...P>
+        struct first_type {using type = T;};
+
+        // Don't want to include `<utility>` for `std::index_sequence`, so I roll my own.
+        // This has a logarithmic instantiation depth, to support long lists.
+        template <size_t ...I>
+        struct index_sequence {};
+        template <typename A, typename B>
+        struct concat_index_sequences {};
+        template <size_t ...A, size_t ...B>
+        struct concat_index_sequences<index_sequence<A...>, index_sequence<B...>> {using type = index_sequence<A..., sizeof...(A) + B...>;};
+        template <size_t N>
+        struct make_index_sequence_helper : concat_index_sequences<typename make_index_sequence_helper<N / 2>::type, typename make_index_sequence_helper<N - N / 2>::type> {};
+        template <>
+        struct make_index_sequence_helper<0> {using type = index_sequence<>;};
+        template <>
+        struct make_index_sequence_helper<1> {using type = index_sequence<0>;};
+        template <size_t N>
+        using make_index_sequence = typename make_index_sequence_helper<N>::type;
+
+        // Expand a pack into this to evaluate an expression for every element, in order.
+        using expand_pack = int[];
+
         // Our reference classes inherit from this.
         struct ReferenceBase {};
+        // Our iterator classes inherit from this.
+        struct IteratorBase {};
+        // Our list classes inherit from this.
+        struct ListBase {};
 
-        // This would be a lambda deep inside Reference, but constexpr lambdas are a C++17 feature.
-        // `T` is the desired type, `U` is a forwarding reference type that `ptr` points to.
-        template <typename T, typename U>
-        constexpr T construct_from_elem(void *ptr)
+        // Whether `T` is one of our list classes, ignoring cvref-qualifiers.
+        template <typename T>
+        struct is_list : std::is_base_of<ListBase, std::remove_cv_t<std::remove_reference_t<T>>> {};
+
+        // A list of types.
+        template <typename ...P>
+        struct type_list {};
+
+        // The `I`-th type in `P...`. This has a constant instantiation depth, unlike the naive recursive implementation.
+        template <size_t I, typename T>
+        struct indexed_type {using type = T;};
+        template <typename Seq, typename ...P>
+        struct indexed_types {};
+        template <size_t ...I, typename ...P>
+        struct indexed_types<index_sequence<I...>, P...> : indexed_type<I, P>... {};
+        template <size_t I, typename T>
+        indexed_type<I, T> select_indexed_type(const indexed_type<I, T> &); // Not defined.
+        template <size_t I, typename ...P>
+        using nth_type = typename decltype(select_indexed_type<I>(declval<indexed_types<make_index_sequence<sizeof...(P)>, P...>>()))::type;
+
+        // Describes how the elements of a list are grouped by their types (including the value categories).
+        // We store and process the elements per distinct type ("kind"), so the amount of template instantiations depends on the number of kinds rather than the list size.
+        template <size_t N>
+        struct list_layout
+        {
+            size_t num_kinds = 0;
+            // Those are indexed by element, and give its kind and its index among the elements of the same kind.
+            size_t kinds[N + (N == 0)] = {};
+            size_t slots[N + (N == 0)] = {};
+            // Those are indexed by kind, and give the first element of this kind, and the number of those elements.
+            size_t firsts[N + (N == 0)] = {};
+            size_t counts[N + (N == 0)] = {};
+        };
+
+        // A unique address for each type. Lets us compare types in constant expressions, without instantiating `std::is_same` for every pair.
+        template <typename T>
+        struct type_tag {static constexpr char value = 0;};
+        #if BETTER_INIT_CXX_STANDARD < 17
+        template <typename T>
+        constexpr char type_tag<T>::value;
+        #endif
+        // Whether the addresses of different `type_tag`s compare unequal in constant expressions.
+        // They don't on GCC with `-fsanitize=undefined`, then we fall back to `std::is_same`, see `same_types`.
+        template <typename A, typename B, typename = void>
+        struct type_tags_are_comparable : std::false_type {};
+        template <typename A, typename B>
+        struct type_tags_are_comparable<A, B, std::enable_if_t<(&type_tag<A>::value != &type_tag<B>::value)>> : std::true_type {};
+
+        // The index of the first `T` in `P...`.
+        template <typename T, typename ...P>
+        constexpr size_t first_index_of()
+        {
+            constexpr bool same[] = {std::is_same<T, P>::value..., true};
+            size_t ret = 0;
+            while (!same[ret])
+                ret++;
+            return ret;
+        }
+
+        // `same_types<...>::equal(i, j)` checks whether the types number `i` and `j` in `P...` are the same.
+        // Normally this compares their `type_tag`s. Otherwise it compares the indices of their first occurrences, which needs a quadratic amount of `std::is_same`s,
+        // but gives the same result, so the grouping doesn't depend on the compiler flags.
+        template <bool CompareTags, typename ...P>
+        struct same_types
+        {
+            static constexpr bool equal(size_t i, size_t j)
+            {
+                constexpr const char *tags[] = {&type_tag<P>::value..., nullptr};
+                return tags[i] == tags[j];
+            }
+        };
+        template <typename ...P>
+        struct same_types<false, P...>
+        {
+            static constexpr bool equal(size_t i, size_t j)
+            {
+                constexpr size_t firsts[] = {first_index_of<P, P...>()..., 0};
+                return firsts[i] == firsts[j];
+            }
+        };
+
+        template <typename ...P>
+        constexpr list_layout<sizeof...(P)> make_list_layout()
+        {
+            using same = same_types<type_tags_are_comparable<ListBase, IteratorBase>::value, P...>;
+            list_layout<sizeof...(P)> ret;
+            for (size_t i = 0; i < sizeof...(P); i++)
+            {
+                size_t kind = 0;
+                while (kind < ret.num_kinds && !same::equal(ret.firsts[kind], i))
+                    kind++;
+                if (kind == ret.num_kinds)
+                    ret.firsts[ret.num_kinds++] = i;
+                ret.kinds[i] = kind;
+                ret.slots[i] = ret.counts[kind]++;
+            }
+            return ret;
+        }
+        // Stores the layout of `P...`. This is a class rather than a variable template, to have the same address in every translation unit.
+        template <typename ...P>
+        struct layout_of {static constexpr list_layout<sizeof...(P)> value = make_list_layout<P...>();};
+        #if BETTER_INIT_CXX_STANDARD < 17
+        template <typename ...P>
+        constexpr list_layout<sizeof...(P)> layout_of<P...>::value;
+        #endif
+
+        // The layout of a list of `N` elements of the same type, which we know without comparing the types. Used for `packed_storage`.
+        template <size_t N>
+        constexpr list_layout<N> make_uniform_layout()
+        {
+            list_layout<N> ret;
+            ret.num_kinds = N > 0;
+            ret.counts[0] = N;
+            for (size_t i = 0; i < N; i++)
+                ret.slots[i] = i;
+            return ret;
+        }
+        template <size_t N>
+        struct uniform_layout {static constexpr list_layout<N> value = make_uniform_layout<N>();};
+        #if BETTER_INIT_CXX_STANDARD < 17
+        template <size_t N>
+        constexpr list_layout<N> uniform_layout<N>::value;
+        #endif
+
+        // The distinct types in `P...`, in the order of their first appearance, as a `type_list`.
+        template <typename Seq, typename ...P>
+        struct distinct_types_helper {};
+        template <size_t ...K, typename ...P>
+        struct distinct_types_helper<index_sequence<K...>, P...> {using type = type_list<nth_type<layout_of<P...>::value.firsts[K], P...>...>;};
+        template <typename ...P>
+        using distinct_types = typename distinct_types_helper<make_index_sequence<layout_of<P...>::value.num_kinds>, P...>::type;
+
+        // Whether some of the types in `type_list<U...>` are our lists.
+        template <typename List>
+        struct has_lists {};
+        template <typename ...U>
+        struct has_lists<type_list<U...>> : std::integral_constant<bool, any_of({is_list<U>::value...})> {};
+
+        // Whether `T` is constructible from an element of forwarding reference type `U`. `args_t` elements are checked against their arguments.
+        template <typename T, typename U, typename D = std::remove_cv_t<std::remove_reference_t<U>>>
+        struct constructible_from_elem : std::is_constructible<T, U &&> {};
+        template <typename T, typename U, typename ...Q>
+        struct constructible_from_elem<T, U, args_t<Q...>> : std::is_constructible<T, Q &&...> {};
+        template <typename T, typename U, typename D = std::remove_cv_t<std::remove_reference_t<U>>>
+        struct nothrow_constructible_from_elem : std::is_nothrow_constructible<T, U &&> {};
+        template <typename T, typename U, typename ...Q>
+        struct nothrow_constructible_from_elem<T, U, args_t<Q...>> : std::is_nothrow_constructible<T, Q &&...> {};
+
+        // Whether `T` is constructible from each of the forwarding references `U...`, listed in `type_list<U...>`.
+        template <typename T, typename List>
+        struct constructible_from_each {};
+        template <typename T, typename ...U>
+        struct constructible_from_each<T, type_list<U...>> : std::integral_constant<bool, all_of({constructible_from_elem<T, U>::value...})> {};
+        template <typename T, typename List>
+        struct nothrow_constructible_from_each {};
+        template <typename T, typename ...U>
+        struct nothrow_constructible_from_each<T, type_list<U...>> : std::integral_constant<bool, all_of({nothrow_constructible_from_elem<T, U>::value...})> {};
+
+        // A pointer to a single element, of forwarding reference type `U`.
+        // We preserve the types rather than storing `void *`, because casting from `void *` is not allowed in constant expressions.
+        // The common base lets us pass those around without knowing `U`, and casting back to the derived class is allowed.
+        struct elem_ref_base {};
+        template <typename U>
+        struct elem_ref : elem_ref_base
+        {
+            std::remove_reference_t<U> *ptr = nullptr;
+        };
+
+        // Pointers to the elements of a single kind `K`, in order.
+        template <size_t K, typename U, size_t Count>
+        struct elem_group
+        {
+            elem_ref<U> refs[Count];
+        };
+        // Returns the group of kind `K`.
+        template <size_t K, typename U, size_t Count>
+        constexpr elem_group<K, U, Count> &get_group(elem_group<K, U, Count> &group) noexcept {return group;}
+
+        // The element storage for a list. Consists of an `elem_group` per kind.
+        template <typename Seq, typename Distinct, typename ...P>
+        struct elem_storage_low {};
+        template <size_t ...K, typename ...U, typename ...P>
+        struct elem_storage_low<index_sequence<K...>, type_list<U...>, P...> : elem_group<K, U, layout_of<P...>::value.counts[K]>...
+        {
+            // The first element of each kind, indexed by kind. Those point into our own groups, so we need a custom copy constructor.
+            const elem_ref_base *groups[sizeof...(K) + (sizeof...(K) == 0)] = {};
+
+            template <size_t ...I>
+            constexpr elem_storage_low(index_sequence<I...>, std::remove_reference_t<P> &... params) noexcept
+                : groups{get_group<K>(*this).refs...}
+            {
+                (void)expand_pack{0, (void(get_group<layout_of<P...>::value.kinds[I]>(*this).refs[layout_of<P...>::value.slots[I]].ptr = &params), 0)...};
+            }
+            constexpr elem_storage_low(const elem_storage_low &other) noexcept
+                : elem_group<K, U, layout_of<P...>::value.counts[K]>(other)..., groups{get_group<K>(*this).refs...}
+            {}
+            elem_storage_low &operator=(const elem_storage_low &) = delete;
+        };
+        template <typename ...P>
+        struct elem_storage : elem_storage_low<make_index_sequence<layout_of<P...>::value.num_kinds>, distinct_types<P...>, P...>
+        {
+            constexpr elem_storage(std::remove_reference_t<P> &... params) noexcept
+                : elem_storage_low<make_index_sequence<layout_of<P...>::value.num_kinds>, distinct_types<P...>, P...>(make_index_sequence<sizeof...(P)>{}, params...)
+            {}
+        };
+
+        // Whether reading an element of forwarding reference type `U` usually copies a non-trivially-copyable lvalue, that could be moved instead.
+        template <typename U>
+        struct is_copied_lvalue : std::integral_constant<bool,
+            std::is_lvalue_reference<U>::value && !std::is_const<std::remove_reference_t<U>>::value && !std::is_trivially_copyable<std::remove_reference_t<U>>::value
+        > {};
+
+        // Warns about non-const lvalues that get copied, see `BETTER_INIT_WARN_LVALUE_COPIES`.
+        template <typename U, std::enable_if_t<!BETTER_INIT_WARN_LVALUE_COPIES || !is_copied_lvalue<U>::value, int> = 0>
+        constexpr void warn_if_copied_lvalue() noexcept {}
+        template <typename U, std::enable_if_t<BETTER_INIT_WARN_LVALUE_COPIES && is_copied_lvalue<U>::value, int> = 0>
+        [[deprecated("better_init: this list element is a non-const lvalue and will be copied. Use `init{...}.moved()` to move it, or make it const to copy on purpose.")]]
+        constexpr void warn_if_copied_lvalue() noexcept {}
+
+        // Returns a forwarding reference to the element number `slot` of kind `K`.
+        template <size_t K, typename U, size_t Count>
+        constexpr U &&get_elem(const elem_group<K, U, Count> &group, size_t slot) noexcept
         {
+            warn_if_copied_lvalue<U>();
             // Don't want to include `<utility>` for `std::forward`.
-            return T(static_cast<U &&>(*reinterpret_cast<std::remove_reference_t<U> *>(ptr)));
+            return static_cast<U &&>(*group.refs[slot].ptr);
+        }
+        // Returns a pointer to the element number `slot` of kind `K`. Unlike `get_elem()`, this doesn't warn about copies.
+        template <size_t K, typename U, size_t Count>
+        constexpr std::remove_reference_t<U> *get_elem_ptr(const elem_group<K, U, Count> &group, size_t slot) noexcept
+        {
+            return group.refs[slot].ptr;
+        }
+
+        // The element storage for a list of `N` prvalues of the same trivially copyable type `U`. Stores copies of them contiguously, instead of pointers.
+        // This lets us give the container a pair of pointers, and it can then copy them all at once. There's only one kind, with `uniform_layout`.
+        template <typename U, size_t N>
+        struct packed_storage
+        {
+            U values[N];
+
+            template <typename ...P>
+            constexpr packed_storage(P &... params) noexcept : values{params...} {}
+        };
+        template <size_t K, typename U, size_t N>
+        constexpr U &&get_elem(const packed_storage<U, N> &storage, size_t slot) noexcept
+        {
+            // The elements are prvalues on the caller side, so we can forward them as rvalues, like `elem_storage` would. They are never modified.
+            return static_cast<U &&>(const_cast<U &>(storage.values[slot]));
+        }
+        template <size_t K, typename U, size_t N>
+        constexpr U *get_elem_ptr(const packed_storage<U, N> &storage, size_t slot) noexcept
+        {
+            return const_cast<U *>(storage.values + slot);
+        }
+
+        // Whether `custom::construct_sized` should be used to construct `T`, instead of `custom::construct`. Defined below.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_construct_sized;
+        // Whether `T` should be constructed by reserving and emplacing elements one by one. Defined below.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_unordered_emplace;
+        // Returns a forwarding reference to the element number `slot` of the group starting at `group`, which must have type `U`.
+        template <typename U>
+        constexpr U &&get_elem_in_group(const elem_ref_base *group, size_t slot) noexcept
+        {
+            warn_if_copied_lvalue<U>();
+            return static_cast<U &&>(*(static_cast<const elem_ref<U> *>(group) + slot)->ptr);
+        }
+
+        // Those would be lambdas deep inside Reference and Iterator, but constexpr lambdas are a C++17 feature.
+        // They depend only on the element type `U` (and the target type), not on the list or the element position,
+        // so all lists share the same instantiations and function tables.
+
+        // Turns non-const lvalue references into rvalue references, for `.moved()`. Leaves other types unchanged.
+        template <typename T>
+        struct moved_elem {using type = T;};
+        template <typename T>
+        struct moved_elem<T &> {using type = T &&;};
+        template <typename T>
+        struct moved_elem<const T &> {using type = const T &;};
+
+        // Whether `T` is a `lazy_t`, ignoring cvref-qualifiers.
+        template <typename T>
+        struct is_lazy : std::false_type {};
+        template <typename F>
+        struct is_lazy<lazy_t<F>> : std::true_type {};
+        template <typename T>
+        struct is_lazy<T &> : is_lazy<std::remove_cv_t<T>> {};
+        template <typename T>
+        struct is_lazy<T &&> : is_lazy<std::remove_cv_t<T>> {};
+
+        // Whether `T` is an `args_t`, ignoring cvref-qualifiers.
+        template <typename T>
+        struct is_args : std::false_type {};
+        template <typename ...P>
+        struct is_args<args_t<P...>> : std::true_type {};
+        template <typename T>
+        struct is_args<T &> : is_args<std::remove_cv_t<T>> {};
+        template <typename T>
+        struct is_args<T &&> : is_args<std::remove_cv_t<T>> {};
+
+        // Constructs a `T` from an element. Lazy elements are called here, so that their result initializes `T` directly, without any moves.
+        // Likewise, `args_t` elements pass their arguments directly to the constructor of `T`.
+        template <typename T, typename U, std::enable_if_t<!is_lazy<U>::value && !is_args<U>::value, int> = 0>
+        constexpr T make_from_elem(U &&elem)
+        {
+            return T(static_cast<U &&>(elem));
+        }
+        template <typename T, typename U, std::enable_if_t<is_args<U>::value, int> = 0>
+        constexpr T make_from_elem(U &&elem)
+        {
+            return elem.template make<T>();
+        }
+        template <typename T, typename U, std::enable_if_t<is_lazy<U>::value, int> = 0>
+        constexpr T make_from_elem(U &&elem)
+        {
+            return T(elem.func());
+        }
+
+        // Constructs a `T` from the element number `slot` of the group `group` of type `U`.
+        template <typename T, typename U>
+        constexpr T construct_from_elem(const elem_ref_base *group, size_t slot)
+        {
+            return make_from_elem<T>(get_elem_in_group<U>(group, slot));
+        }
+        // Calls `func` with the element number `slot` of the group `group` of type `U`.
+        template <typename F, typename U>
+        constexpr void call_with_elem(F &func, const elem_ref_base *group, size_t slot)
+        {
+            func(get_elem_in_group<U>(group, slot));
         }
 
+        // Tables of the functions above, indexed by kind. `List` is the `type_list` of the distinct element types of a list.
+        template <typename T, typename List>
+        struct elem_constructors {};
+        template <typename T, typename ...U>
+        struct elem_constructors<T, type_list<U...>>
+        {
+            using func = T (*)(const elem_ref_base *, size_t);
+            static constexpr func value[] = {construct_from_elem<T, U>...};
+        };
+        template <typename F, typename List>
+        struct elem_callers {};
+        template <typename F, typename ...U>
+        struct elem_callers<F, type_list<U...>>
+        {
+            using func = void (*)(F &, const elem_ref_base *, size_t);
+            static constexpr func value[] = {call_with_elem<F, U>...};
+        };
+        #if BETTER_INIT_CXX_STANDARD < 17
+        template <typename T, typename ...U>
+        constexpr typename elem_constructors<T, type_list<U...>>::func elem_constructors<T, type_list<U...>>::value[sizeof...(U)];
+        template <typename F, typename ...U>
+        constexpr typename elem_callers<F, type_list<U...>>::func elem_callers<F, type_list<U...>>::value[sizeof...(U)];
+        #endif
+
         #if BETTER_INIT_ALLOCATOR_HACK
         namespace allocator_hack
         {
-            // Constructs a `T` at `target` using allocator `alloc`, passing a forwarding reference to `U` as an argument, which points to `ptr`.
+            // Constructs a `T` at `target` using allocator `alloc`, from the arguments passed to it.
+            template <typename A, typename T>
+            struct allocator_construct_func
+            {
+                A &alloc;
+                T *target;
+
+                template <typename ...Q>
+                constexpr void operator()(Q &&... params) const
+                {
+                    std::allocator_traits<A>::construct(alloc, target, static_cast<Q &&>(params)...);
+                }
+            };
+
+            // Constructs a `T` at `target` using allocator `alloc`, from an element. For `args_t`, passes the arguments instead.
+            template <typename A, typename T, typename U, std::enable_if_t<!is_args<U>::value, int> = 0>
+            constexpr void construct_from_elem_with_alloc(A &alloc, T *target, U &&elem)
+            {
+                std::allocator_traits<A>::construct(alloc, target, static_cast<U &&>(elem));
+            }
+            template <typename A, typename T, typename U, std::enable_if_t<is_args<U>::value, int> = 0>
+            constexpr void construct_from_elem_with_alloc(A &alloc, T *target, U &&elem)
+            {
+                elem.apply(allocator_construct_func<A, T>{alloc, target});
+            }
+
+            // Constructs a `T` at `target` using allocator `alloc`, passing a forwarding reference to the element number `slot` of the group `group` of type `U` as an argument.
             template <typename T, typename U, typename A>
-            constexpr void construct_from_elem_at(A &alloc, void *ptr, T *target)
+            constexpr void construct_from_elem_at(A &alloc, const elem_ref_base *group, size_t slot, T *target)
             {
-                std::allocator_traits<A>::template construct(alloc, target, static_cast<U &&>(*reinterpret_cast<std::remove_reference_t<U> *>(ptr)));
+                construct_from_elem_with_alloc(alloc, target, get_elem_in_group<U>(group, slot));
             }
+            // A table of the above, like `elem_constructors`.
+            template <typename T, typename A, typename List>
+            struct elem_constructors_at {};
+            template <typename T, typename A, typename ...U>
+            struct elem_constructors_at<T, A, type_list<U...>>
+            {
+                using func = void (*)(A &, const elem_ref_base *, size_t, T *);
+                static constexpr func value[] = {construct_from_elem_at<T, U, A>...};
+            };
+            #if BETTER_INIT_CXX_STANDARD < 17
+            template <typename T, typename A, typename ...U>
+            constexpr typename elem_constructors_at<T, A, type_list<U...>>::func elem_constructors_at<T, A, type_list<U...>>::value[sizeof...(U)];
+            #endif
+
+            // Constructs a container `T` at `target` from a pair of iterators, using allocator `A` rebound to `T`. Used for nested lists.
+            template <typename A, typename T>
+            struct construct_container_at_func;
+
+            // See below.
+            template <typename T, typename = void>
+            struct has_replaceable_allocator;
         }
         #endif
 
@@ -261,233 +905,1940 @@ namespace better_init
         template <typename T, typename Iter, typename ...P>
         struct constructible_from_iters : constructible_from_iters_helper<void, T, Iter, P...> {};
 
+        // Whether `T` is constructible from a pair of `Iter`s over sorted elements, using `custom::construct_sorted`.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct sorted_constructible_from_iters_helper : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct sorted_constructible_from_iters_helper<decltype(void(custom::construct_sorted<void, T, Iter, P...>{}(declval<Iter &&>(), declval<Iter &&>(), declval<P &&>()...))), T, Iter, P...> : std::true_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct sorted_constructible_from_iters : sorted_constructible_from_iters_helper<void, T, Iter, P...> {};
+
         template <typename T, typename Iter, typename ...P>
         struct nothrow_constructible_from_iters : std::integral_constant<bool, noexcept(custom::construct<void, T, Iter, P...>{}(declval<Iter &&>(), declval<Iter &&>(), declval<P &&>()...))> {};
+
+        // Returns a prvalue, unlike `declval()`. Good for checking initialization that relies on mandatory copy elision.
+        template <typename T>
+        T prvalue() noexcept; // Not defined.
+
+        // Whether `T{E...}` is valid, where each `E` is a prvalue, and there's one per element of `P...`.
+        template <typename Void, typename T, typename E, typename ...P>
+        struct brace_constructible_from_prvalues : std::false_type {};
+        template <typename T, typename E, typename ...P>
+        struct brace_constructible_from_prvalues<decltype(void(T{prvalue<typename first_type<E, P>::type>()...})), T, E, P...> : std::true_type {};
+
+        // See `custom::array_size`.
+        // In C++14 we don't have `std::is_aggregate`, so we check that there's nothing in the class except the elements.
+        template <typename T, typename>
+        struct default_array_size {};
+        template <template <typename, size_t> class A, typename E, size_t N>
+        struct default_array_size<A<E, N>,
+            std::enable_if_t<
+                std::is_same<typename A<E, N>::value_type, E>::value &&
+                #if BETTER_INIT_CXX_STANDARD >= 17
+                std::is_aggregate<A<E, N>>::value
+                #else
+                sizeof(A<E, N>) == sizeof(E) * N
+                #endif
+            >
+        > : std::integral_constant<size_t, N> {};
+
+        // See `custom::allocation_size`.
+        template <typename T, size_t N, typename>
+        struct default_allocation_size {};
+        template <typename T, size_t N>
+        struct default_allocation_size<T, N, void_t<typename custom::element_type<T>::type, decltype(declval<T &>().data()), decltype(declval<T &>().reserve(size_t{})), decltype(declval<T &>().emplace_back())>>
+            : std::integral_constant<size_t, N * sizeof(typename custom::element_type<T>::type)>
+        {};
+
+        // Whether `custom::array_size<T>` is defined.
+        template <typename T, typename = void>
+        struct has_array_size : std::false_type {};
+        template <typename T>
+        struct has_array_size<T, void_t<decltype(custom::array_size<T>::value)>> : std::true_type {};
+
+        // See `custom::allow_implicit_init`.
+        template <typename T, typename>
+        struct default_allow_implicit_init : std::integral_constant<bool, std::is_constructible<T, any_init_list>::value || has_array_size<T>::value> {};
     }
 
-    #if BETTER_INIT_ALLOW_BRACES
-    #define DETAIL_BETTER_INIT_CLASS_NAME BETTER_INIT_IDENTIFIER
-    #else
-    #define DETAIL_BETTER_INIT_CLASS_NAME helper
+    // Pass `better_init::sorted` to `.to<T>()` to indicate that the elements are already sorted, e.g. `init{...}.to<std::map<K, V>>(better_init::sorted)`.
+    // Then the elements are inserted with an end hint (which takes amortized constant time per element), or for flat containers, `std::sorted_unique` is used.
+    // See `custom::construct_sorted` and `BETTER_INIT_CHECK_SORTED`.
+    struct sorted_t {explicit sorted_t() = default;};
+    #if BETTER_INIT_CXX_STANDARD >= 17
+    inline // Otherwise it has internal linkage, and can't be exported from the module, see `better_init.cppm`.
     #endif
+    constexpr sorted_t sorted{};
 
-    template <typename ...P>
-    class BETTER_INIT_NODISCARD DETAIL_BETTER_INIT_CLASS_NAME
+    #if BETTER_INIT_PARALLEL
+    // Pass this to `.to<T>()` to construct the elements concurrently. Use `better_init::parallel()` to create it.
+    template <typename E>
+    struct parallel_t
     {
-      public:
-        // Whether this list can be used to initialize a range of `T`s.
-        template <typename T> static constexpr bool can_initialize_elem         = detail::all_of({std::is_constructible        <T, P &&>::value...});
-        template <typename T> static constexpr bool can_nothrow_initialize_elem = detail::all_of({std::is_nothrow_constructible<T, P &&>::value...});
+        E executor;
+    };
 
-      private:
-        template <typename T>
-        class Reference : public detail::ReferenceBase
-        {
-            friend DETAIL_BETTER_INIT_CLASS_NAME;
-            void *target = nullptr;
-            detail::size_t index = 0;
+    // `init{...}.to<T>(better_init::parallel(executor), extra...)` constructs the elements concurrently, which helps if they're expensive to construct.
+    // `executor(n, func)` must call `func(i)` once for each `i` in `[0, n)`, possibly concurrently, and return when all of those calls have returned.
+    // If the allocator hack is enabled (see `BETTER_INIT_ALLOCATOR_HACK`) and `T` is vector-like (has `.data()` and an allocator we can replace),
+    // the elements are constructed directly in the final storage, so this works with non-movable types. That's the only way to construct them in place.
+    // Otherwise they are constructed in a temporary buffer on the heap, and are then moved into the container, which costs one extra move per element.
+    template <typename E>
+    constexpr parallel_t<std::decay_t<E>> parallel(E &&executor)
+    {
+        return {static_cast<E &&>(executor)};
+    }
 
-            constexpr Reference() {}
+    namespace detail
+    {
+        // Constructs one object, remembering the exception it throws (if any), so it doesn't escape into the executor.
+        // `C` is one of the functions below, `parallel_construct()` passes this to the executor.
+        template <typename T, typename C>
+        struct parallel_construct_func
+        {
+            const C *construct;
+            T *target;
+            std::exception_ptr *errors;
 
-          public:
+            void operator()(size_t i) const
+            {
+                #if __cpp_exceptions
+                try
+                {
+                    (*construct)(i, target + i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+                #else
+                (*construct)(i, target + i);
+                #endif
+            }
+        };
 
-            // Non-copyable.
-            // The list creates and owns all its references, and exposes actual references to them.
-            // This is because pre-C++20 iterator requirements force us to return actual references from `*`, and more importantly `[]`.
-            Reference(const Reference &) = delete;
-            Reference &operator=(const Reference &) = delete;
+        // Constructs `N` objects at `target` concurrently, by calling `construct(i, target + i)` through `executor`.
+        // If any of them throw, destroys the rest using `destroy(ptr)`, and rethrows the first exception.
+        template <size_t N, typename T, typename E, typename C, typename D>
+        void parallel_construct(E &executor, T *target, const C &construct, const D &destroy)
+        {
+            std::exception_ptr errors[N];
+            executor(N, parallel_construct_func<T, C>{&construct, target, errors});
+            for (size_t i = 0; i < N; i++)
+            {
+                if (errors[i])
+                {
+                    for (size_t j = 0; j < N; j++)
+                    {
+                        if (!errors[j])
+                            destroy(target + j);
+                    }
+                    std::rethrow_exception(errors[i]);
+                }
+            }
+        }
 
-            // Conversion operators, for empty and non-empty ranges.
+        // Constructs the `i`-th element of the range starting at `begin`, using the placement `new`.
+        template <typename Iter>
+        struct parallel_placement_construct_func
+        {
+            const Iter *begin;
 
-            template <typename U = T, std::enable_if_t<detail::dependent_value<U, sizeof...(P) == 0>::value, int> = 0>
-            constexpr operator T() const noexcept(can_nothrow_initialize_elem<T>)
+            template <typename T>
+            void operator()(size_t i, T *target) const
             {
-                // Note: This is intentionally not a SFINAE check nor a `static_assert`, to support init from empty lists.
-                detail::abort();
+                ::new(static_cast<void *>(target)) T((*begin)[ptrdiff_t(i)]);
             }
-            template <typename U = T, std::enable_if_t<detail::dependent_value<U, sizeof...(P) != 0>::value, int> = 0>
-            constexpr operator T() const noexcept(can_nothrow_initialize_elem<T>)
+        };
+
+        // Destroys an object by calling its destructor.
+        struct destroy_func
+        {
+            template <typename T>
+            void operator()(T *ptr) const
             {
-                constexpr T (*lambdas[])(void *) = {detail::construct_from_elem<T, P>...};
-                return lambdas[index](target);
+                ptr->~T();
             }
+        };
 
-            #if BETTER_INIT_ALLOCATOR_HACK
-            // Those construct an object at the specified address.
+        // Uninitialized heap storage for `n` objects of type `T`, freed when it goes out of scope.
+        template <typename T>
+        class temporary_buffer
+        {
+            std::allocator<T> alloc;
+            T *ptr;
+            size_t n;
 
-            template <typename U = T, typename Alloc, std::enable_if_t<detail::dependent_value<U, sizeof...(P) == 0>::value, int> = 0>
-            constexpr void allocator_hack_construct_at(Alloc &, T *) const noexcept(can_nothrow_initialize_elem<T>)
-            {
-                detail::abort();
-            }
-            template <typename U = T, typename Alloc, std::enable_if_t<detail::dependent_value<U, sizeof...(P) != 0>::value, int> = 0>
-            constexpr void allocator_hack_construct_at(Alloc &alloc, T *location) const noexcept(can_nothrow_initialize_elem<T>)
+          public:
+            explicit temporary_buffer(size_t n) : ptr(alloc.allocate(n)), n(n) {}
+            temporary_buffer(const temporary_buffer &) = delete;
+            temporary_buffer &operator=(const temporary_buffer &) = delete;
+
+            ~temporary_buffer()
             {
-                constexpr void (*lambdas[])(Alloc &, void *, T *) = {detail::allocator_hack::construct_from_elem_at<T, P, Alloc>...};
-                return lambdas[index](alloc, target, location);
+                alloc.deallocate(ptr, n);
             }
-            #endif
+
+            T *data() const noexcept {return ptr;}
         };
 
+        // Destroys `n` objects at `ptr` when it goes out of scope.
         template <typename T>
-        class Iterator
+        class destroy_n_guard
         {
-            friend class DETAIL_BETTER_INIT_CLASS_NAME;
-            const Reference<T> *ref = nullptr;
+            T *ptr;
+            size_t n;
 
           public:
-            // Need this for the C++20 `std::iterator_traits` auto-detection to kick in.
+            destroy_n_guard(T *ptr, size_t n) noexcept : ptr(ptr), n(n) {}
+            destroy_n_guard(const destroy_n_guard &) = delete;
+            destroy_n_guard &operator=(const destroy_n_guard &) = delete;
+
+            ~destroy_n_guard()
+            {
+                for (size_t i = 0; i < n; i++)
+                    ptr[i].~T();
+            }
+        };
+
+        // Whether `T` stores its elements contiguously, which is required for constructing them in place concurrently.
+        template <typename T, typename = void>
+        struct is_contiguous_container : std::false_type {};
+        template <typename T>
+        struct is_contiguous_container<T, std::enable_if_t<std::is_same<decltype(declval<T &>().data()), typename custom::element_type<T>::type *>::value>> : std::true_type {};
+
+        #if BETTER_INIT_ALLOCATOR_HACK
+        namespace allocator_hack
+        {
+            // Constructs the `i`-th element of the range starting at `begin` using an allocator, see `Reference::allocator_hack_construct_at()`.
+            template <typename Iter, typename A>
+            struct parallel_construct_at_func
+            {
+                const Iter *begin;
+                A *alloc;
+
+                template <typename T>
+                void operator()(size_t i, T *target) const
+                {
+                    (*begin)[ptrdiff_t(i)].allocator_hack_construct_at(*alloc, target);
+                }
+            };
+
+            // Destroys an object using an allocator.
+            template <typename A>
+            struct destroy_at_func
+            {
+                A *alloc;
+
+                template <typename T>
+                void operator()(T *ptr) const
+                {
+                    std::allocator_traits<A>::destroy(*alloc, ptr);
+                }
+            };
+        }
+        #endif
+    }
+    #endif
+
+    #if BETTER_INIT_ALLOW_BRACES
+    #define DETAIL_BETTER_INIT_CLASS_NAME BETTER_INIT_IDENTIFIER
+    #else
+    #define DETAIL_BETTER_INIT_CLASS_NAME helper
+    #endif
+
+    namespace detail
+    {
+        // A reference to a single argument of `args_t`, of forwarding reference type `U`.
+        template <size_t I, typename U>
+        struct arg_ref
+        {
+            std::remove_reference_t<U> *ptr;
+        };
+        template <size_t I, typename U>
+        constexpr U &&get_arg(const arg_ref<I, U> &ref) noexcept
+        {
+            return static_cast<U &&>(*ref.ptr);
+        }
+
+        template <typename Seq, typename ...P>
+        struct arg_refs {};
+        template <size_t ...I, typename ...P>
+        struct arg_refs<index_sequence<I...>, P...> : arg_ref<I, P>...
+        {
+            constexpr arg_refs(std::remove_reference_t<P> &... params) noexcept : arg_ref<I, P>{&params}... {}
+
+            template <typename T>
+            constexpr T make() const
+            {
+                return T(get_arg<I>(*this)...);
+            }
+
+            template <typename F>
+            constexpr decltype(auto) apply(F &&func) const
+            {
+                return static_cast<F &&>(func)(get_arg<I>(*this)...);
+            }
+        };
+    }
+
+    template <typename ...P>
+    class args_t
+    {
+        detail::arg_refs<detail::make_index_sequence<sizeof...(P)>, P...> refs;
+
+      public:
+        constexpr args_t(P &&... params) noexcept : refs(params...) {}
+
+        // Constructs a `T` from the arguments. Used by `detail::make_from_elem()`.
+        template <typename T>
+        constexpr T make() const
+        {
+            return refs.template make<T>();
+        }
+
+        // Calls `func(args...)`. Used to construct the element in place, e.g. with the placement `new` or `.emplace_back()`.
+        template <typename F>
+        constexpr decltype(auto) apply(F &&func) const
+        {
+            return refs.apply(static_cast<F &&>(func));
+        }
+
+        // This is used only when something forwards the element itself to the constructor of `T`, e.g. `.emplace_back()` or the allocator hack.
+        // This also makes `std::is_constructible` work as expected for the element.
+        template <typename T, std::enable_if_t<std::is_constructible<T, P &&...>::value, int> = 0>
+        constexpr operator T() const
+        {
+            return make<T>();
+        }
+    };
+
+    // `init{better_init::args(a, b, c), ...}` adds an element that is constructed from several arguments, as `T(a, b, c)`.
+    // The element is constructed directly in its final location (in C++17 and newer), so this works with non-movable types.
+    // This stores references to the arguments, like the list itself, so use it only in the same full-expression.
+    template <typename ...P>
+    BETTER_INIT_NODISCARD constexpr args_t<P...> args(P &&... params) noexcept
+    {
+        return args_t<P...>(static_cast<P &&>(params)...);
+    }
+
+    // A vector with a fixed capacity and inline storage, see below.
+    template <typename T, detail::size_t N>
+    class inline_vector;
+
+    template <typename ...P>
+    class BETTER_INIT_NODISCARD DETAIL_BETTER_INIT_CLASS_NAME : public detail::ListBase
+    {
+      public:
+        // Whether this list can be used to initialize a range of `T`s.
+        // Those are checked once per distinct element type.
+        template <typename T> static constexpr bool can_initialize_elem         = detail::constructible_from_each        <T, detail::distinct_types<P...>>::value;
+        template <typename T> static constexpr bool can_nothrow_initialize_elem = detail::nothrow_constructible_from_each<T, detail::distinct_types<P...>>::value;
+
+        // Whether all elements have the same type, including the value category.
+        // Note that we can't relax this to just comparing the decayed types, since the elements are forwarded differently depending on their value categories.
+        static constexpr bool is_homogeneous = detail::all_same<P...>::value;
+
+        // Whether the elements are prvalues of the same trivially copyable type, which we then store by value, see `detail::packed_storage`.
+        // The type must also be copyable, since we copy the elements into the storage, and the container copies them from there.
+        static constexpr bool is_packed = sizeof...(P) > 0 && is_homogeneous && BETTER_INIT_PACK_TRIVIAL_ELEMENTS &&
+            !std::is_reference<typename detail::first_type<P..., void>::type>::value && std::is_trivially_copyable<typename detail::first_type<P..., void>::type>::value &&
+            std::is_copy_constructible<typename detail::first_type<P..., void>::type>::value;
+
+        // Whether some of the elements are lists themselves, e.g. in `init{init{1, 2}, init{3, 4}}`.
+        static constexpr bool has_nested_lists = detail::has_lists<detail::distinct_types<P...>>::value;
+
+      private:
+        // How our elements are grouped by type, see `detail::list_layout`.
+        using layout = std::conditional_t<is_packed, detail::uniform_layout<sizeof...(P)>, detail::layout_of<P...>>;
+
+        // Pointers to our elements, or their copies if `is_packed`.
+        using elems_type = std::conditional_t<is_packed,
+            detail::packed_storage<std::remove_cv_t<typename detail::first_type<P..., void>::type>, sizeof...(P)>,
+            detail::elem_storage<P...>
+        >;
+
+        // Used to select between the overloads of `Reference::convert_low()`, `Reference::allocator_hack_construct_at_low()`, and `Iterator::for_each_elem_low()`.
+        // The function pointer tables are indexed by kind.
+        // Empty lists get an empty `index_sequence`.
+        using dispatch_tag = std::conditional_t<layout::value.num_kinds == 1, std::true_type, detail::make_index_sequence<layout::value.num_kinds>>;
+
+        template <typename T>
+        class IteratorStorage;
+
+        template <typename T>
+        class Reference : public detail::ReferenceBase
+        {
+            friend DETAIL_BETTER_INIT_CLASS_NAME;
+            friend IteratorStorage<T>;
+            const elems_type *elems = nullptr;
+            detail::size_t index = 0;
+
+            constexpr Reference(const elems_type *elems, detail::size_t index) noexcept : elems(elems), index(index) {}
+
+            // Those are called by the conversion operator, for homogeneous and heterogeneous lists respectively.
+            // They are templates only to avoid being instantiated by `template class` (not instantiating `get_elem` for an empty list).
+            template <typename U = T>
+            constexpr U convert_low(std::true_type) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                return detail::make_from_elem<T>(detail::get_elem<0>(*elems, index));
+            }
+            template <detail::size_t ...K>
+            constexpr T convert_low(detail::index_sequence<K...>) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::size_t kind = layout::value.kinds[index];
+                detail::hook<hook_event::dispatch, T>();
+                return detail::elem_constructors<T, detail::distinct_types<P...>>::value[kind](elems->groups[kind], layout::value.slots[index]);
+            }
+
+            #if BETTER_INIT_ALLOCATOR_HACK
+            template <typename Alloc>
+            constexpr void allocator_hack_construct_at_low(std::true_type, Alloc &alloc, T *location) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::allocator_hack::construct_from_elem_with_alloc(alloc, location, detail::get_elem<0>(*elems, index));
+            }
+            template <typename Alloc, detail::size_t ...K>
+            constexpr void allocator_hack_construct_at_low(detail::index_sequence<K...>, Alloc &alloc, T *location) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::size_t kind = layout::value.kinds[index];
+                detail::hook<hook_event::dispatch, T>();
+                detail::allocator_hack::elem_constructors_at<T, Alloc, detail::distinct_types<P...>>::value[kind](alloc, elems->groups[kind], layout::value.slots[index], location);
+            }
+            #endif
+
+          public:
+
+            // Non-copyable.
+            // Without `BETTER_INIT_PROXY_ITERATORS`, the list creates and owns all its references, and exposes actual references to them.
+            // This is because pre-C++20 iterator requirements force us to return actual references from `*`, and more importantly `[]`.
+            // With `BETTER_INIT_PROXY_ITERATORS`, they are returned by value, relying on mandatory copy elision.
+            Reference(const Reference &) = delete;
+            Reference &operator=(const Reference &) = delete;
+
+            // Conversion operators, for empty and non-empty ranges.
+
+            template <typename U = T, std::enable_if_t<detail::dependent_value<U, sizeof...(P) == 0>::value, int> = 0>
+            constexpr operator T() const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                // Note: This is intentionally not a SFINAE check nor a `static_assert`, to support init from empty lists.
+                detail::abort();
+            }
+            template <typename U = T, std::enable_if_t<detail::dependent_value<U, sizeof...(P) != 0>::value, int> = 0>
+            constexpr operator T() const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::hook<hook_event::convert_elem, T>();
+                return convert_low(dispatch_tag{});
+            }
+
+            #if BETTER_INIT_ALLOCATOR_HACK
+            // Those construct an object at the specified address.
+
+            template <typename U = T, typename Alloc, std::enable_if_t<detail::dependent_value<U, sizeof...(P) == 0>::value, int> = 0>
+            constexpr void allocator_hack_construct_at(Alloc &, T *) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::abort();
+            }
+            template <typename U = T, typename Alloc, std::enable_if_t<detail::dependent_value<U, sizeof...(P) != 0>::value, int> = 0>
+            constexpr void allocator_hack_construct_at(Alloc &alloc, T *location) const noexcept(can_nothrow_initialize_elem<T>)
+            {
+                detail::hook<hook_event::allocator_construct, T>();
+                allocator_hack_construct_at_low(dispatch_tag{}, alloc, location);
+            }
+            #endif
+        };
+
+        template <typename T>
+        class Iterator : public detail::IteratorBase
+        {
+            friend class DETAIL_BETTER_INIT_CLASS_NAME;
+            friend IteratorStorage<T>;
+
+            // `pos` is either an index or a pointer to a `Reference`, and we do the same arithmetic on it in both cases.
+            #if BETTER_INIT_PROXY_ITERATORS
+            const elems_type *elems = nullptr;
+            detail::ptrdiff_t pos = 0;
+
+            constexpr Iterator(const elems_type *elems, detail::ptrdiff_t pos) noexcept : elems(elems), pos(pos) {}
+
+            constexpr const elems_type &get_elems() const noexcept {return *elems;}
+            #else
+            const Reference<T> *pos = nullptr;
+
+            constexpr const elems_type &get_elems() const noexcept {return *pos->elems;}
+            #endif
+
+            // Those implement `for_each_elem()`. Short heterogeneous lists use a pack expansion, see `BETTER_INIT_UNROLL_LIMIT`.
+            // Otherwise it's a loop rather than a pack expansion, to keep the compilation time and the code size small.
+            template <typename F, detail::size_t ...I>
+            constexpr void for_each_elem_unrolled(detail::index_sequence<I...>, F &func) const
+            {
+                (void)detail::expand_pack{0, (void(func(detail::get_elem<layout::value.kinds[I]>(get_elems(), layout::value.slots[I]))), 0)...};
+            }
+            template <typename F>
+            constexpr void for_each_elem_low(std::false_type, F &func) const
+            {
+                for_each_elem_unrolled(detail::make_index_sequence<sizeof...(P)>{}, func);
+            }
+            template <typename F>
+            constexpr void for_each_elem_low(std::true_type, F &func) const
+            {
+                for (detail::size_t i = 0; i < sizeof...(P); i++)
+                    func(detail::get_elem<0>(get_elems(), i));
+            }
+            template <typename F>
+            constexpr void for_each_elem_low(detail::index_sequence<>, F &) const {}
+            template <typename F, detail::size_t ...K>
+            constexpr void for_each_elem_low(detail::index_sequence<K...>, F &func) const
+            {
+                for (detail::size_t i = 0; i < sizeof...(P); i++)
+                {
+                    detail::size_t kind = layout::value.kinds[i];
+                    detail::hook<hook_event::dispatch, F>();
+                    detail::elem_callers<F, detail::distinct_types<P...>>::value[kind](func, get_elems().groups[kind], layout::value.slots[i]);
+                }
+            }
+
+          public:
+            // Need this for the C++20 `std::iterator_traits` auto-detection to kick in.
             // Note that at least libstdc++'s category detection needs this to match the return type of `*`, except for cvref-qualifiers.
             // It's tempting to put `void` or some broken type here, to prevent extracting values from the range, which we don't want.
             // But that causes problems, and just `Reference` is enough, since it's non-copyable anyway.
             using value_type = Reference<T>;
-            #if !BETTER_INIT_SMART_ITERATOR_TRAITS
+            // Proxy iterators must spell the category explicitly, otherwise C++20 `std::iterator_traits` would guess `std::input_iterator_tag`.
+            #if !BETTER_INIT_SMART_ITERATOR_TRAITS || BETTER_INIT_PROXY_ITERATORS
             using iterator_category = std::random_access_iterator_tag;
             using reference = Reference<T>;
             using pointer = void;
             using difference_type = detail::ptrdiff_t;
             #endif
 
-            constexpr Iterator() noexcept {}
+            // See the same variable in the list class.
+            static constexpr bool has_nested_lists = DETAIL_BETTER_INIT_CLASS_NAME::has_nested_lists;
+            // The number of elements in the list.
+            static constexpr detail::size_t list_size = sizeof...(P);
+
+            constexpr Iterator() noexcept {}
+
+            #if BETTER_INIT_PROXY_ITERATORS
+            constexpr Reference<T> operator*() const noexcept {return Reference<T>(elems, detail::size_t(pos));}
+            #else
+            // `LegacyForwardIterator` requires us to return an actual reference here.
+            constexpr const Reference<T> &operator*() const noexcept {return *pos;}
+            #endif
+
+            // No `operator->`. This causes C++20 `std::iterator_traits` to guess `pointer_type == void`, which sounds ok to me.
+
+            // Don't want to rely on `<compare>`.
+            friend constexpr bool operator==(Iterator a, Iterator b) noexcept
+            {
+                return a.pos == b.pos;
+            }
+            friend constexpr bool operator!=(Iterator a, Iterator b) noexcept
+            {
+                return !(a == b);
+            }
+            friend constexpr bool operator<(Iterator a, Iterator b) noexcept
+            {
+                // Both point into the same array of references (if they're pointers), so comparing them directly is fine, and works in constant expressions.
+                return a.pos < b.pos;
+            }
+            friend constexpr bool operator> (Iterator a, Iterator b) noexcept {return b < a;}
+            friend constexpr bool operator<=(Iterator a, Iterator b) noexcept {return !(b < a);}
+            friend constexpr bool operator>=(Iterator a, Iterator b) noexcept {return !(a < b);}
+
+            constexpr Iterator &operator++() noexcept
+            {
+                ++pos;
+                return *this;
+            }
+            constexpr Iterator &operator--() noexcept
+            {
+                --pos;
+                return *this;
+            }
+            constexpr Iterator operator++(int) noexcept
+            {
+                Iterator ret = *this;
+                ++*this;
+                return ret;
+            }
+            constexpr Iterator operator--(int) noexcept
+            {
+                Iterator ret = *this;
+                --*this;
+                return ret;
+            }
+            constexpr friend Iterator operator+(Iterator it, detail::ptrdiff_t n) noexcept {it += n; return it;}
+            constexpr friend Iterator operator+(detail::ptrdiff_t n, Iterator it) noexcept {it += n; return it;}
+            constexpr friend Iterator operator-(Iterator it, detail::ptrdiff_t n) noexcept {it -= n; return it;}
+            // There's no `number - iterator`.
+
+            constexpr friend detail::ptrdiff_t operator-(Iterator a, Iterator b) noexcept {return a.pos - b.pos;}
+
+            constexpr Iterator &operator+=(detail::ptrdiff_t n) noexcept {pos += n; return *this;}
+            constexpr Iterator &operator-=(detail::ptrdiff_t n) noexcept {pos -= n; return *this;}
+
+            #if BETTER_INIT_PROXY_ITERATORS
+            constexpr Reference<T> operator[](detail::ptrdiff_t i) const noexcept
+            #else
+            constexpr const Reference<T> &operator[](detail::ptrdiff_t i) const noexcept
+            #endif
+            {
+                return *(*this + i);
+            }
+
+            // Calls `func` for every element of the list, in order, passing them as forwarding references to their original types.
+            // This bypasses `Reference`, and is used by some of the `detail::default_construct` specializations.
+            // Must be called on the `begin` iterator of a range that wasn't modified.
+            template <typename F>
+            constexpr void for_each_elem(F &&func) const
+            {
+                for_each_elem_low(std::conditional_t<(layout::value.num_kinds > 1 && sizeof...(P) <= BETTER_INIT_UNROLL_LIMIT), std::false_type, dispatch_tag>{}, func);
+            }
+        };
+
+        // Could use `[[no_unique_address]]`, but it's our only member variable anyway.
+        // Can't store `Reference`s here directly, because we can't use a templated `operator T` in our elements,
+        // because it doesn't work correctly on MSVC (but not on GCC and Clang).
+        elems_type elems;
+
+        // A pair of iterators over a non-empty list, plus whatever they point to. Must not be moved, since the iterators can point into it.
+        template <typename T>
+        class IteratorStorage
+        {
+          public:
+            Iterator<T> begin, end;
+
+            #if BETTER_INIT_PROXY_ITERATORS
+            constexpr IteratorStorage(const elems_type &elems) noexcept
+                : begin(&elems, 0), end(&elems, sizeof...(P))
+            {}
+            #else
+            // Could use `std::array`, but want to use less headers.
+            // Must store `Reference`s here, because `std::random_access_iterator` requires `operator[]` to return the same type as `operator*`,
+            // and `LegacyForwardIterator` requires `operator*` to return an actual reference. If we don't have those here, we don't have anything for the references to point to.
+            Reference<T> refs[sizeof...(P)];
+
+            template <detail::size_t ...I>
+            constexpr IteratorStorage(const elems_type &elems, detail::index_sequence<I...>) noexcept
+                : refs{{&elems, I}...}
+            {
+                begin.pos = refs;
+                end.pos = refs + sizeof...(P);
+            }
+
+            constexpr IteratorStorage(const elems_type &elems) noexcept
+                : IteratorStorage(elems, detail::make_index_sequence<sizeof...(P)>{})
+            {}
+            #endif
+
+            IteratorStorage(const IteratorStorage &) = delete;
+            IteratorStorage &operator=(const IteratorStorage &) = delete;
+        };
+
+        // Replaces `IteratorStorage` for empty lists, which can't have an array of references.
+        template <typename T>
+        struct EmptyIteratorStorage
+        {
+            Iterator<T> begin, end;
+
+            constexpr EmptyIteratorStorage(const elems_type &) noexcept {}
+        };
+
+        // A range over this list, using `T` as the element type. Returned by `.range<T>()`.
+        // Stores a copy of the element pointers, so it doesn't depend on the lifetime of the list itself.
+        template <typename T>
+        class Range
+        {
+            friend DETAIL_BETTER_INIT_CLASS_NAME;
+            elems_type elems;
+            std::conditional_t<sizeof...(P) == 0, EmptyIteratorStorage<T>, IteratorStorage<T>> iters;
+
+            constexpr Range(const elems_type &source) noexcept : elems(source), iters(elems) {}
+
+          public:
+            // Copying makes new iterators, pointing to our own copy of the elements.
+            constexpr Range(const Range &other) noexcept : elems(other.elems), iters(elems) {}
+            Range &operator=(const Range &) = delete;
+
+            constexpr Iterator<T> begin() const noexcept {return iters.begin;}
+            constexpr Iterator<T> end() const noexcept {return iters.end;}
+
+            // Static, so the size is usable in constant expressions even if the range isn't.
+            static constexpr detail::size_t size() noexcept {return sizeof...(P);}
+            static constexpr bool empty() noexcept {return sizeof...(P) == 0;}
+        };
+
+        #if BETTER_INIT_PARALLEL && BETTER_INIT_ALLOCATOR_HACK
+        // Used by `.to(parallel_t<E>)` to construct vector-like containers in place.
+        // The allocator hack gives the first of those references the location of the first element, and we construct all elements there at once, concurrently.
+        // The remaining references do nothing. This relies on the container constructing the elements in order, in contiguous storage.
+        template <typename T, typename E>
+        class ParallelReference : public detail::ReferenceBase
+        {
+            friend DETAIL_BETTER_INIT_CLASS_NAME;
+            const Iterator<T> *begin = nullptr;
+            E *executor = nullptr;
+            detail::size_t index = 0;
+
+            constexpr ParallelReference(const Iterator<T> *begin, E *executor, detail::size_t index) noexcept : begin(begin), executor(executor), index(index) {}
+
+          public:
+            ParallelReference(const ParallelReference &) = delete;
+            ParallelReference &operator=(const ParallelReference &) = delete;
+
+            // This is only used if the container doesn't construct its elements using the allocator. Then they're constructed one by one.
+            operator T() const
+            {
+                return (*begin)[detail::ptrdiff_t(index)];
+            }
+
+            template <typename Alloc>
+            void allocator_hack_construct_at(Alloc &alloc, T *location) const
+            {
+                if (index == 0)
+                {
+                    detail::parallel_construct<sizeof...(P)>(*executor, location,
+                        detail::allocator_hack::parallel_construct_at_func<Iterator<T>, Alloc>{begin, &alloc},
+                        detail::allocator_hack::destroy_at_func<Alloc>{&alloc}
+                    );
+                }
+            }
+        };
+        #endif
+
+        // Those implement `can_[nothrow_]initialize_range`.
+        // They reject types without `custom::element_type` in a SFINAE-friendly way. This matters because without CTAD, our conversion operators
+        // are considered when constructing a list from a single element, with the element type as the target type.
+        template <typename Void, typename T, typename ...Q>
+        struct range_check : std::false_type {};
+        template <typename T, typename ...Q>
+        struct range_check<detail::void_t<typename custom::element_type<T>::type>, T, Q...>
+            : std::integral_constant<bool, detail::constructible_from_iters<T, Iterator<typename custom::element_type<T>::type>, Q...>::value && can_initialize_elem<typename custom::element_type<T>::type>>
+        {};
+        template <typename Void, typename T, typename ...Q>
+        struct nothrow_range_check : std::false_type {};
+        template <typename T, typename ...Q>
+        struct nothrow_range_check<detail::void_t<typename custom::element_type<T>::type>, T, Q...>
+            : std::integral_constant<bool, detail::nothrow_constructible_from_iters<T, Iterator<typename custom::element_type<T>::type>, Q...>::value && can_nothrow_initialize_elem<typename custom::element_type<T>::type>>
+        {};
+
+        // Those implement `can_[nothrow_]initialize_array`.
+        template <typename Void, typename T>
+        struct array_check : std::false_type {};
+        template <typename T>
+        struct array_check<detail::void_t<typename custom::element_type<T>::type, decltype(custom::array_size<T>::value)>, T>
+            : std::integral_constant<bool,
+                custom::array_size<T>::value == sizeof...(P) &&
+                can_initialize_elem<typename custom::element_type<T>::type> &&
+                detail::brace_constructible_from_prvalues<void, T, typename custom::element_type<T>::type, P...>::value
+            >
+        {};
+        template <typename T, typename = void>
+        struct nothrow_array_check : std::false_type {};
+        template <typename T>
+        struct nothrow_array_check<T, std::enable_if_t<array_check<void, T>::value>>
+            : std::integral_constant<bool,
+                can_nothrow_initialize_elem<typename custom::element_type<T>::type> &&
+                (BETTER_INIT_HAVE_MANDATORY_COPY_ELISION || std::is_nothrow_move_constructible<typename custom::element_type<T>::type>::value)
+            >
+        {};
+
+        // Implements `.to(sorted_t, ...)`.
+        template <typename Void, typename T, typename ...Q>
+        struct sorted_check : std::false_type {};
+        template <typename T, typename ...Q>
+        struct sorted_check<detail::void_t<typename custom::element_type<T>::type>, T, Q...>
+            : std::integral_constant<bool, detail::sorted_constructible_from_iters<T, Iterator<typename custom::element_type<T>::type>, Q...>::value && can_initialize_elem<typename custom::element_type<T>::type>>
+        {};
+
+        // Implements `.to(...)`: whether to construct `T` from a pair of pointers to our packed elements (see `is_packed`), rather than from our iterators.
+        template <typename Void, typename T, typename ...Q>
+        struct packed_check : std::false_type {};
+        template <typename T, typename ...Q>
+        struct packed_check<std::enable_if_t<detail::dependent_value<T, is_packed>::value>, T, Q...>
+            : std::integral_constant<bool,
+                std::is_same<typename custom::element_type<T>::type, std::remove_cv_t<typename detail::first_type<P..., void>::type>>::value &&
+                detail::constructible_from_iters<T, const typename custom::element_type<T>::type *, Q...>::value &&
+                // If the user customized the construction from a known number of elements, respect that.
+                !detail::use_construct_sized<void, T, Iterator<typename custom::element_type<T>::type>, Q...>::value &&
+                // Pointers don't help unordered containers, they still insert elements one by one.
+                !detail::use_unordered_emplace<void, T, Iterator<typename custom::element_type<T>::type>, Q...>::value
+            >
+        {};
+
+        template <typename T, typename ...Q>
+        constexpr T to_range_low(std::true_type, Q &&... extra_args) const
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            return custom::construct<void, T, const elem_type *, Q...>{}(elems.values + 0, elems.values + sizeof...(P), static_cast<Q &&>(extra_args)...);
+        }
+        template <typename T, typename ...Q>
+        constexpr T to_range_low(std::false_type, Q &&... extra_args) const
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            IteratorStorage<elem_type> iters(elems);
+            return custom::construct<void, T, Iterator<elem_type>, Q...>{}(iters.begin, iters.end, static_cast<Q &&>(extra_args)...);
+        }
+
+        template <typename T, detail::size_t ...I>
+        constexpr T to_array_low(detail::index_sequence<I...>) const
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            return T{detail::make_from_elem<elem_type>(detail::get_elem<layout::value.kinds[I]>(elems, layout::value.slots[I]))...};
+        }
+
+        #if BETTER_INIT_PARALLEL
+        // Those implement `.to(parallel_t<E>, ...)`. This is how we construct `T`:
+        // 0 = can't, 1 = sequentially (for empty lists), 2 = concurrently in place (see `ParallelReference`), 3 = concurrently in a temporary heap buffer, then moved.
+        // Only 2 constructs the elements in their final location. Without the allocator hack, there's no way to construct elements in a container's existing storage.
+        template <typename Void, typename T, typename ...Q>
+        struct parallel_mode : std::integral_constant<int, 0> {};
+        template <typename T, typename ...Q>
+        struct parallel_mode<detail::void_t<typename custom::element_type<T>::type>, T, Q...>
+            : std::integral_constant<int,
+                sizeof...(P) == 0 ? (range_check<void, T, Q...>::value ? 1 : 0) :
+                #if BETTER_INIT_ALLOCATOR_HACK
+                detail::allocator_hack::has_replaceable_allocator<T>::value && detail::is_contiguous_container<T>::value && range_check<void, T, Q...>::value ? 2 :
+                #endif
+                can_initialize_elem<typename custom::element_type<T>::type> &&
+                std::is_move_constructible<typename custom::element_type<T>::type>::value &&
+                detail::constructible_from_iters<T, std::move_iterator<typename custom::element_type<T>::type *>, Q...>::value ? 3 : 0
+            >
+        {};
+
+        template <typename T, typename E, typename ...Q>
+        T to_parallel_low(std::integral_constant<int, 1>, E &, Q &&... extra_args) const
+        {
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).template to<T>(static_cast<Q &&>(extra_args)...);
+        }
+        #if BETTER_INIT_ALLOCATOR_HACK
+        template <typename T, typename E, typename ...Q>
+        T to_parallel_low(std::integral_constant<int, 2>, E &executor, Q &&... extra_args) const
+        {
+            return to_parallel_in_place<T>(detail::make_index_sequence<sizeof...(P)>{}, executor, static_cast<Q &&>(extra_args)...);
+        }
+        template <typename T, typename E, typename ...Q, detail::size_t ...I>
+        T to_parallel_in_place(detail::index_sequence<I...>, E &executor, Q &&... extra_args) const
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            using ref_type = ParallelReference<elem_type, E>;
+            IteratorStorage<elem_type> iters(elems);
+            const ref_type refs[] = {{&iters.begin, &executor, I}...};
+            return custom::construct<void, T, const ref_type *, Q...>{}(refs, refs + sizeof...(P), static_cast<Q &&>(extra_args)...);
+        }
+        #endif
+        template <typename T, typename E, typename ...Q>
+        T to_parallel_low(std::integral_constant<int, 3>, E &executor, Q &&... extra_args) const
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            IteratorStorage<elem_type> iters(elems);
+            // Not on the stack, since the lists can be long and the elements large.
+            detail::temporary_buffer<elem_type> buffer(sizeof...(P));
+            elem_type *first = buffer.data();
+            detail::parallel_construct<sizeof...(P)>(executor, first, detail::parallel_placement_construct_func<Iterator<elem_type>>{&iters.begin}, detail::destroy_func{});
+            detail::destroy_n_guard<elem_type> guard(first, sizeof...(P));
+            using iter_type = std::move_iterator<elem_type *>;
+            return custom::construct<void, T, iter_type, Q...>{}(iter_type(first), iter_type(first + sizeof...(P)), static_cast<Q &&>(extra_args)...);
+        }
+        #endif
+
+      public:
+        // Whether this list can be used to initialize a range type `T`, with extra constructor parameters `P...`.
+        template <typename T, typename ...Q> static constexpr bool can_initialize_range         = range_check        <void, T, Q...>::value;
+        template <typename T, typename ...Q> static constexpr bool can_nothrow_initialize_range = nothrow_range_check<void, T, Q...>::value;
+
+        // Whether this list can be used to initialize a fixed-size aggregate `T` (see `custom::array_size`).
+        // The size of `T` must match the size of the list.
+        template <typename T> static constexpr bool can_initialize_array         = array_check        <void, T>::value;
+        template <typename T> static constexpr bool can_nothrow_initialize_array = nothrow_array_check<T>::value;
+
+        // How many bytes constructing `T` from this list allocates for its element storage, see `custom::allocation_size`.
+        // Use this to size an arena (such as `std::pmr::monotonic_buffer_resource`) in advance, adding what the elements allocate, if anything.
+        template <typename T> static constexpr detail::size_t allocation_size = custom::allocation_size<T, sizeof...(P)>::value;
+
+        // The constructor from a braced (or parenthesized) list.
+        // No `[[nodiscard]]` because GCC 9 complains. Having it on the entire class should be enough.
+        constexpr DETAIL_BETTER_INIT_CLASS_NAME(P &&... params) noexcept
+            : elems(params...)
+        {}
+
+      private:
+        template <detail::size_t ...I>
+        constexpr DETAIL_BETTER_INIT_CLASS_NAME<typename detail::moved_elem<P>::type...> moved_low(detail::index_sequence<I...>) const noexcept
+        {
+            return DETAIL_BETTER_INIT_CLASS_NAME<typename detail::moved_elem<P>::type...>(
+                static_cast<typename detail::moved_elem<P>::type &&>(*detail::get_elem_ptr<layout::value.kinds[I]>(elems, layout::value.slots[I]))...
+            );
+        }
+
+      public:
+        // Returns a list of the same elements, where the non-const lvalues are turned into rvalues, so they're moved rather than copied.
+        // Use this when you're done with those variables, like `std::vector<std::string> v = init{a, b, c}.moved();`.
+        BETTER_INIT_NODISCARD constexpr DETAIL_BETTER_INIT_CLASS_NAME<typename detail::moved_elem<P>::type...> moved() const && noexcept
+        {
+            return moved_low(detail::make_index_sequence<sizeof...(P)>{});
+        }
+
+      private:
+        template <typename F, detail::size_t ...I>
+        constexpr void for_each_low(detail::index_sequence<I...>, F &func) const
+        {
+            (void)detail::expand_pack{0, (void(func(static_cast<P &&>(*detail::get_elem_ptr<layout::value.kinds[I]>(elems, layout::value.slots[I])))), 0)...};
+        }
+
+      public:
+        // Calls `func(elem)` for every element, in order, passing them as forwarding references to their original types `P &&...`.
+        // Unlike the iterators, this doesn't go through `Reference`, so there's no common element type and no runtime dispatch.
+        // Useful for heterogeneous consumers, such as type-specific pools. Note that the list doesn't own its elements, so rvalues can be consumed only once.
+        template <typename F>
+        constexpr void for_each(F &&func) const &&
+        {
+            for_each_low(detail::make_index_sequence<sizeof...(P)>{}, func);
+        }
+
+        // Returns `func(elem)` for the element number `I`, passing it as a forwarding reference to its original type, like `for_each()`.
+        template <detail::size_t I, typename F, std::enable_if_t<(I < sizeof...(P)), int> = 0>
+        constexpr decltype(auto) visit(F &&func) const &&
+        {
+            return static_cast<F &&>(func)(static_cast<detail::nth_type<I, P...> &&>(*detail::get_elem_ptr<layout::value.kinds[I]>(elems, layout::value.slots[I])));
+        }
+
+        // The conversion functions below are `&&`-qualified as a reminder that your initializer elements can be dangling.
+
+        // Implicit conversion to a container. Implicit-ness is only enabled when it has a `std::initializer_list` constructor.
+        template <typename T, std::enable_if_t<can_initialize_range<T> && custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr operator T() const && noexcept(can_nothrow_initialize_range<T>)
+        {
+            // Don't want to include `<utility>` for `std::move`.
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+        }
+        // Explicit conversion to a container.
+        template <typename T, std::enable_if_t<can_initialize_range<T> && !custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr explicit operator T() const && noexcept(can_nothrow_initialize_range<T>)
+        {
+            // Don't want to include `<utility>` for `std::move`.
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+        }
+
+        // Implicit conversion to a fixed-size aggregate.
+        template <typename T, std::enable_if_t<can_initialize_array<T> && custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr operator T() const && noexcept(can_nothrow_initialize_array<T>)
+        {
+            // Don't want to include `<utility>` for `std::move`.
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+        }
+        // Explicit conversion to a fixed-size aggregate.
+        template <typename T, std::enable_if_t<can_initialize_array<T> && !custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr explicit operator T() const && noexcept(can_nothrow_initialize_array<T>)
+        {
+            // Don't want to include `<utility>` for `std::move`.
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+        }
+
+        // Conversion to a fixed-size aggregate. Each element is constructed in place (in C++17 and newer), so this works with non-movable types.
+        template <typename T, std::enable_if_t<can_initialize_array<T>, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to() const && noexcept(can_nothrow_initialize_array<T>)
+        {
+            return to_array_low<T>(detail::make_index_sequence<sizeof...(P)>{});
+        }
+
+        // Conversion to a container with extra arguments (such as an allocator).
+        template <typename T, typename ...Q, std::enable_if_t<can_initialize_range<T, Q...> && sizeof...(P) == 0, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to(Q &&... extra_args) const && noexcept(can_nothrow_initialize_range<T, Q...>)
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            return custom::construct<void, T, Iterator<elem_type>, Q...>{}(Iterator<elem_type>{}, Iterator<elem_type>{}, static_cast<Q &&>(extra_args)...);
+        }
+        // Conversion to a container with extra arguments (such as an allocator).
+        // If the elements are packed (see `is_packed`), the container receives a pair of pointers to them instead of our iterators.
+        template <typename T, typename ...Q, std::enable_if_t<can_initialize_range<T, Q...> && sizeof...(P) != 0, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to(Q &&... extra_args) const && noexcept(can_nothrow_initialize_range<T, Q...>)
+        {
+            return to_range_low<T>(packed_check<void, T, Q...>{}, static_cast<Q &&>(extra_args)...);
+        }
+
+        // Conversion to a container with extra arguments, from elements that are already sorted, see `better_init::sorted`.
+        template <typename T, typename ...Q, std::enable_if_t<sorted_check<void, T, Q...>::value && sizeof...(P) == 0, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to(sorted_t, Q &&... extra_args) const &&
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            return custom::construct_sorted<void, T, Iterator<elem_type>, Q...>{}(Iterator<elem_type>{}, Iterator<elem_type>{}, static_cast<Q &&>(extra_args)...);
+        }
+        template <typename T, typename ...Q, std::enable_if_t<sorted_check<void, T, Q...>::value && sizeof...(P) != 0, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to(sorted_t, Q &&... extra_args) const &&
+        {
+            using elem_type = typename custom::element_type<T>::type;
+            IteratorStorage<elem_type> iters(elems);
+            return custom::construct_sorted<void, T, Iterator<elem_type>, Q...>{}(iters.begin, iters.end, static_cast<Q &&>(extra_args)...);
+        }
+
+        #if BETTER_INIT_PARALLEL
+        // Conversion to a container with extra arguments, constructing the elements concurrently using `par.executor`, see `better_init::parallel()`.
+        template <typename T, typename E, typename ...Q, std::enable_if_t<parallel_mode<void, T, Q...>::value != 0, int> = 0>
+        BETTER_INIT_NODISCARD T to(parallel_t<E> par, Q &&... extra_args) const &&
+        {
+            return to_parallel_low<T>(parallel_mode<void, T, Q...>{}, par.executor, static_cast<Q &&>(extra_args)...);
+        }
+        #endif
+
+        // Conversion to a container with an allocator constructed from `resource`, such as `std::pmr::vector` with a `std::pmr::memory_resource`.
+        // Equivalent to `.to<T>(typename T::allocator_type(resource))`. Vector-like containers request exactly `allocation_size<T>` bytes from the resource for their element storage, at once.
+        // If the elements are allocator-aware themselves (e.g. `std::pmr::string`s), they also receive the allocator, and make their own allocations.
+        template <typename T, typename R, std::enable_if_t<std::is_constructible<typename T::allocator_type, R *>::value && can_initialize_range<T, typename T::allocator_type>, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to_pmr(R *resource) const && noexcept(can_nothrow_initialize_range<T, typename T::allocator_type>)
+        {
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).template to<T>(typename T::allocator_type(resource));
+        }
+
+        // Calls `func(begin, end)` with a pair of iterators over this list, using `T` as the element type, and returns the result.
+        // The iterators are only valid during the call.
+        template <typename T, typename F, std::enable_if_t<detail::dependent_value<T, sizeof...(P) == 0>::value, int> = 0>
+        constexpr decltype(auto) with_iterators(F &&func) const &&
+        {
+            return static_cast<F &&>(func)(Iterator<T>{}, Iterator<T>{});
+        }
+        template <typename T, typename F, std::enable_if_t<detail::dependent_value<T, sizeof...(P) != 0>::value, int> = 0>
+        constexpr decltype(auto) with_iterators(F &&func) const &&
+        {
+            IteratorStorage<T> iters(elems);
+            return static_cast<F &&>(func)(iters.begin, iters.end);
+        }
+
+        // Returns a range over this list, using `T` as the element type. This is a `std::ranges::sized_range`, usable with `std::ranges::to<C>()`,
+        // C++23 `C(std::from_range, ...)` constructors, range algorithms (such as `std::ranges::uninitialized_copy()`), and range-based `for` loops.
+        // It points to the original elements, so it's valid only while they are (they are often temporaries), and the rvalue elements can be consumed only once.
+        template <typename T, std::enable_if_t<can_initialize_elem<T>, int> = 0>
+        BETTER_INIT_NODISCARD constexpr Range<T> range() const && noexcept
+        {
+            return Range<T>(elems);
+        }
+
+        // The number of elements.
+        static constexpr detail::size_t size() noexcept {return sizeof...(P);}
+
+        // Converts to a `better_init::inline_vector<T, N>`, where `N` is the number of elements, so nothing is allocated on the heap.
+        // Since C++17 this works with non-movable types, the same as `std::vector`.
+        template <typename T>
+        BETTER_INIT_NODISCARD inline_vector<T, sizeof...(P)> to_inline() const &&
+        {
+            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).template to<inline_vector<T, sizeof...(P)>>();
+        }
+
+        #if BETTER_INIT_ALLOCATOR_HACK
+        // Constructs a container at the specified address, using the allocator of the enclosing container rebound to `T`.
+        // This is used for nested lists, to construct the inner containers directly in the outer one, see `allocator_hack::should_wrap_construction`.
+        template <typename Alloc, typename T, std::enable_if_t<can_initialize_range<T>, int> = 0>
+        constexpr void allocator_hack_construct_at(Alloc &alloc, T *location) const &&
+        {
+            static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).template with_iterators<typename custom::element_type<T>::type>(detail::allocator_hack::construct_container_at_func<Alloc, T>{alloc, location});
+        }
+        #endif
+    };
+
+    #if BETTER_INIT_ALLOW_BRACES
+    // A deduction guide for the list class.
+    template <typename ...P>
+    DETAIL_BETTER_INIT_CLASS_NAME(P &&...) -> DETAIL_BETTER_INIT_CLASS_NAME<P...>;
+    #else
+    // A helper function to construct the list class.
+    template <typename ...P>
+    BETTER_INIT_NODISCARD constexpr DETAIL_BETTER_INIT_CLASS_NAME<P...> BETTER_INIT_IDENTIFIER(P &&... params) noexcept
+    {
+        return DETAIL_BETTER_INIT_CLASS_NAME<P...>(static_cast<P &&>(params)...);
+    }
+    #endif
+
+    namespace detail
+    {
+        // The element factory for `custom::construct_sized` and `custom::append_sized`. Defined below.
+        template <typename Iter>
+        struct elem_factory;
+
+        // Calls `custom::insert` with the iterators passed to it.
+        template <typename T, typename Pos>
+        struct insert_func
+        {
+            T &container;
+            Pos pos;
+
+            template <typename Iter>
+            constexpr decltype(auto) operator()(Iter begin, Iter end) const
+            {
+                return custom::insert<void, T, Iter, Pos>{}(container, static_cast<Pos>(pos), static_cast<Iter &&>(begin), static_cast<Iter &&>(end));
+            }
+        };
+    }
+
+    // Inserts the elements of `list` into `container` before `pos`, without creating a temporary container.
+    // By default this calls `container.insert(pos, begin, end)`, see `custom::insert`.
+    // Our iterators are random-access, so the container knows the number of elements in advance, and can grow only once.
+    template <typename T, typename Pos, typename ...P>
+    constexpr decltype(auto) insert(T &container, Pos pos, const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&list)
+    {
+        return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&>(list).template with_iterators<typename custom::element_type<T>::type>(detail::insert_func<T, Pos>{container, static_cast<Pos &&>(pos)});
+    }
+
+    namespace detail
+    {
+        // Whether `custom::append_sized` should be used to append to `T`, instead of `custom::insert`.
+        template <typename Void, typename T, typename Iter>
+        struct use_append_sized : std::false_type {};
+        template <typename T, typename Iter>
+        struct use_append_sized<void_t<decltype(custom::append_sized<void, T, Iter::list_size, elem_factory<Iter>>{}(declval<T &>(), declval<elem_factory<Iter>>()))>, T, Iter>
+            : std::true_type
+        {};
+
+        // Calls `custom::append_sized` if it's specialized, or `custom::insert` at the end of the container otherwise.
+        template <typename T>
+        struct append_func
+        {
+            T &container;
+
+            template <typename Iter, std::enable_if_t<use_append_sized<void, T, Iter>::value, int> = 0>
+            constexpr decltype(auto) operator()(Iter begin, Iter) const
+            {
+                return custom::append_sized<void, T, Iter::list_size, elem_factory<Iter>>{}(container, elem_factory<Iter>{static_cast<Iter &&>(begin)});
+            }
+            template <typename Iter, std::enable_if_t<!use_append_sized<void, T, Iter>::value, int> = 0>
+            constexpr decltype(auto) operator()(Iter begin, Iter end) const
+            {
+                using pos_type = decltype(container.end());
+                return insert_func<T, pos_type>{container, container.end()}(static_cast<Iter &&>(begin), static_cast<Iter &&>(end));
+            }
+        };
+    }
+
+    // Inserts the elements of `list` at the end of `container`. See `insert()` above.
+    // If `custom::append_sized` is specialized for `T`, it's used instead, and receives all elements as one batch of a known size.
+    template <typename T, typename ...P>
+    constexpr decltype(auto) append(T &container, const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&list)
+    {
+        return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&>(list).template with_iterators<typename custom::element_type<T>::type>(detail::append_func<T>{container});
+    }
+
+    namespace detail
+    {
+        // Constructs a `T` at `target` from an element, using the placement `new`. Lazy elements are called here, like in `make_from_elem()`.
+        template <typename T, typename U, std::enable_if_t<!is_lazy<U>::value && !is_args<U>::value, int> = 0>
+        void placement_construct_from_elem(T *target, U &&elem)
+        {
+            ::new(static_cast<void *>(target)) T(static_cast<U &&>(elem));
+        }
+        template <typename T>
+        struct placement_new_func
+        {
+            T *target;
+
+            template <typename ...Q>
+            void operator()(Q &&... params) const
+            {
+                ::new(static_cast<void *>(target)) T(static_cast<Q &&>(params)...);
+            }
+        };
+        template <typename T, typename U, std::enable_if_t<is_args<U>::value, int> = 0>
+        void placement_construct_from_elem(T *target, U &&elem)
+        {
+            elem.apply(placement_new_func<T>{target});
+        }
+        template <typename T, typename U, std::enable_if_t<is_lazy<U>::value, int> = 0>
+        void placement_construct_from_elem(T *target, U &&elem)
+        {
+            ::new(static_cast<void *>(target)) T(elem.func());
+        }
+
+        // Constructs the elements passed to it one after another, starting at `pos`.
+        template <typename T>
+        struct placement_construct_elem_func
+        {
+            T *pos;
+
+            template <typename U>
+            void operator()(U &&elem)
+            {
+                placement_construct_from_elem(pos, static_cast<U &&>(elem));
+                pos++;
+            }
+        };
+
+        // Those implement `uninitialized_construct()`, without and with the cleanup on exceptions respectively.
+        template <typename T, typename Iter>
+        T *uninitialized_construct_low(std::true_type, Iter begin, T *dest) noexcept
+        {
+            placement_construct_elem_func<T> func{dest};
+            begin.for_each_elem(func);
+            return func.pos;
+        }
+        template <typename T, typename Iter>
+        T *uninitialized_construct_low(std::false_type, Iter begin, T *dest)
+        {
+            placement_construct_elem_func<T> func{dest};
+            #if __cpp_exceptions
+            try
+            {
+                begin.for_each_elem(func);
+            }
+            catch (...)
+            {
+                while (func.pos != dest)
+                    (--func.pos)->~T();
+                throw;
+            }
+            #else
+            begin.for_each_elem(func);
+            #endif
+            return func.pos;
+        }
+
+        // Calls `uninitialized_construct_low()` with the iterators passed to it.
+        template <typename T, bool Nothrow>
+        struct uninitialized_construct_func
+        {
+            T *dest;
+
+            template <typename Iter>
+            T *operator()(Iter begin, Iter) const noexcept(Nothrow)
+            {
+                return uninitialized_construct_low(std::integral_constant<bool, Nothrow>{}, begin, dest);
+            }
+        };
+    }
+
+    // Constructs the elements of `list` at `dest`, which must point to uninitialized storage for `sizeof...(P)` objects of type `T`.
+    // Each object is constructed directly from its element, as if by `::new(dest + i) T(elem)`, without a container and without `Reference`.
+    // Returns the pointer past the last object. If one of the constructors throws, destroys the objects constructed so far, and rethrows the exception.
+    // If the list is `can_nothrow_initialize_elem<T>`, that cleanup code isn't generated at all.
+    template <typename T, typename ...P, std::enable_if_t<DETAIL_BETTER_INIT_CLASS_NAME<P...>::template can_initialize_elem<T>, int> = 0>
+    T *uninitialized_construct(const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&list, T *dest) noexcept(DETAIL_BETTER_INIT_CLASS_NAME<P...>::template can_nothrow_initialize_elem<T>)
+    {
+        constexpr bool nothrow = DETAIL_BETTER_INIT_CLASS_NAME<P...>::template can_nothrow_initialize_elem<T>;
+        return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME<P...> &&>(list).template with_iterators<T>(detail::uninitialized_construct_func<T, nothrow>{dest});
+    }
+
+    namespace detail
+    {
+        // One value of `better_init::stored`. `I` makes the bases distinct.
+        // The value is initialized with parentheses rather than braces, so narrowing conversions are allowed, like in `stored_array`.
+        template <size_t I, typename T>
+        struct stored_value
+        {
+            T value;
+
+            template <typename Q>
+            constexpr stored_value(empty, Q &&param) : value(static_cast<Q &&>(param)) {}
+        };
+
+        // Stores the values of `better_init::stored`, as a single object.
+        template <typename Seq, typename ...P>
+        struct stored_values {};
+        template <size_t ...I, typename ...P>
+        struct stored_values<index_sequence<I...>, P...> : stored_value<I, P>...
+        {
+            template <typename ...Q>
+            constexpr stored_values(empty, Q &&... params) : stored_value<I, P>(empty{}, static_cast<Q &&>(params))... {}
+
+            constexpr DETAIL_BETTER_INIT_CLASS_NAME<const P &...> list() const noexcept
+            {
+                return DETAIL_BETTER_INIT_CLASS_NAME<const P &...>(static_cast<const stored_value<I, P> &>(*this).value...);
+            }
+        };
+
+        // Stores the values of `better_init::stored`, if they all have the same trivially copyable type. Then containers can copy them in bulk.
+        template <typename Seq, typename T>
+        struct stored_array {};
+        template <size_t ...I, typename T>
+        struct stored_array<index_sequence<I...>, T>
+        {
+            T values[sizeof...(I)];
+
+            template <typename ...Q>
+            constexpr stored_array(empty, Q &&... params) : values{T(static_cast<Q &&>(params))...} {}
+
+            constexpr DETAIL_BETTER_INIT_CLASS_NAME<typename indexed_type<I, const T &>::type...> list() const noexcept
+            {
+                return DETAIL_BETTER_INIT_CLASS_NAME<typename indexed_type<I, const T &>::type...>(values[I]...);
+            }
+        };
+    }
+
+    // An owning list: stores copies of the elements, and can be converted to containers repeatedly, copying the elements each time.
+    // Use this instead of `init{...}` when you construct the same contents many times, and the elements are expensive to compute.
+    // Has the same conversions as `init{...}`. `.list()` returns a regular list referring to the stored elements, for everything else.
+    // If all elements have the same trivially copyable type, and the container has the same element type, it's constructed from a pair of pointers,
+    // which lets it copy all elements at once.
+    template <typename ...P>
+    class stored
+    {
+        using first_type = typename detail::first_type<P..., void>::type;
+        static constexpr bool use_array = sizeof...(P) > 0 && detail::all_same<P...>::value && std::is_trivially_copyable<first_type>::value;
+
+        std::conditional_t<use_array,
+            detail::stored_array<detail::make_index_sequence<sizeof...(P)>, first_type>,
+            detail::stored_values<detail::make_index_sequence<sizeof...(P)>, P...>
+        > storage;
+
+        // Implements `to()`: whether to construct `T` from a pair of pointers to our array, rather than from `.list()`.
+        template <typename Void, typename T, typename ...Q>
+        struct bulk_check : std::false_type {};
+        template <typename T, typename ...Q>
+        struct bulk_check<std::enable_if_t<detail::dependent_value<T, use_array>::value && std::is_same<typename custom::element_type<T>::type, first_type>::value>, T, Q...>
+            : detail::constructible_from_iters<T, const first_type *, Q...>
+        {};
+
+        template <typename T, typename ...Q>
+        constexpr T to_low(std::true_type, Q &&... extra_args) const
+        {
+            return custom::construct<void, T, const first_type *, Q...>{}(storage.values + 0, storage.values + sizeof...(P), static_cast<Q &&>(extra_args)...);
+        }
+        template <typename T, typename ...Q>
+        constexpr T to_low(std::false_type, Q &&... extra_args) const
+        {
+            return storage.list().template to<T>(static_cast<Q &&>(extra_args)...);
+        }
+
+      public:
+        // The regular list type, referring to our elements.
+        using list_type = DETAIL_BETTER_INIT_CLASS_NAME<const P &...>;
+
+        // Whether this can be converted to `T`, either to a container or a fixed-size aggregate.
+        template <typename T> static constexpr bool can_initialize = list_type::template can_initialize_range<T> || list_type::template can_initialize_array<T>;
+
+        // Copies or moves `params...` into the storage. Not a copy constructor (that one is implicit).
+        template <typename ...Q, std::enable_if_t<
+            sizeof...(Q) == sizeof...(P) &&
+            !std::is_same<std::decay_t<typename detail::first_type<Q..., void>::type>, stored>::value &&
+            detail::all_of({std::is_constructible<P, Q &&>::value...}),
+        int> = 0>
+        constexpr stored(Q &&... params) : storage(detail::empty{}, static_cast<Q &&>(params)...) {}
+
+        // Returns a regular list, referring to our elements.
+        BETTER_INIT_NODISCARD constexpr list_type list() const noexcept
+        {
+            return storage.list();
+        }
+
+        // Implicit conversion to a container or a fixed-size aggregate, see the list class.
+        template <typename T, std::enable_if_t<can_initialize<T> && custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr operator T() const
+        {
+            return to<T>();
+        }
+        // Explicit conversion to a container or a fixed-size aggregate, see the list class.
+        template <typename T, std::enable_if_t<can_initialize<T> && !custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr explicit operator T() const
+        {
+            return to<T>();
+        }
+
+        // Conversion to a container or a fixed-size aggregate, with extra arguments, see the list class.
+        template <typename T, typename ...Q>
+        BETTER_INIT_NODISCARD constexpr auto to(Q &&... extra_args) const -> decltype(detail::declval<list_type>().template to<T>(detail::declval<Q>()...))
+        {
+            return to_low<T>(bulk_check<void, T, Q...>{}, static_cast<Q &&>(extra_args)...);
+        }
+    };
+
+    #if BETTER_INIT_CXX_STANDARD >= 17
+    template <typename ...P>
+    stored(P &&...) -> stored<std::decay_t<P>...>;
+    #endif
+
+    // Creates a `better_init::stored` from decayed copies of `params...`. Since C++17, you can also use CTAD: `better_init::stored(...)`.
+    template <typename ...P>
+    BETTER_INIT_NODISCARD constexpr stored<std::decay_t<P>...> make_stored(P &&... params)
+    {
+        return stored<std::decay_t<P>...>(static_cast<P &&>(params)...);
+    }
+
+    // A vector with a fixed capacity `N`, that stores its elements inline, without allocating.
+    // Usually created by `init{...}.to_inline<T>()`, which sets `N` to the number of elements.
+    // Since C++17, the elements are constructed in place from the list, so this works with non-movable types.
+    // Can't be copied or assigned. The move constructor (which must be accessible before C++17, for `.to_inline()`) moves the elements one by one, and exists only if `T` is movable.
+    template <typename T, detail::size_t N>
+    class inline_vector
+    {
+        // Not `T[N]`, to construct the elements only when they're added. At least one byte, since arrays can't be empty.
+        alignas(T) unsigned char storage[sizeof(T) * (N > 0 ? N : 1)];
+        detail::size_t count = 0;
+
+        // Replaces the parameter of the move constructor when `T` isn't movable.
+        struct not_movable {};
+
+      public:
+        using value_type = T;
+        using size_type = detail::size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        inline_vector() noexcept {}
+
+        // Constructs the elements from a pair of iterators, of which there must be at most `N`, otherwise stops the program with `BETTER_INIT_ABORT`.
+        // Delegating to the default constructor means the elements constructed so far are destroyed if one of them throws.
+        template <typename Iter, std::enable_if_t<std::is_constructible<T, decltype(*detail::declval<Iter &>())>::value, int> = 0>
+        inline_vector(Iter begin, Iter end) : inline_vector()
+        {
+            for (; begin != end; ++begin)
+                emplace_back(*begin);
+        }
+
+        // If `T` isn't movable, the parameter is a private type instead, so this isn't a move constructor. There's no implicit one because of the destructor,
+        // and the implicit copy constructor is deleted because of the deleted move assignment.
+        inline_vector(std::conditional_t<std::is_move_constructible<T>::value, inline_vector, not_movable> &&other) noexcept(std::is_nothrow_move_constructible<T>::value) : inline_vector()
+        {
+            for (T &elem : other)
+                emplace_back(static_cast<T &&>(elem));
+        }
+        inline_vector &operator=(inline_vector &&) = delete;
+
+        ~inline_vector() {clear();}
+
+        static constexpr detail::size_t capacity() noexcept {return N;}
+        detail::size_t size() const noexcept {return count;}
+        bool empty() const noexcept {return count == 0;}
+
+        T *data() noexcept
+        {
+            #if __cpp_lib_launder
+            // `std::launder` requires an object to exist at that address, so we can't use it when we're empty.
+            if (count == 0)
+                return reinterpret_cast<T *>(storage);
+            return std::launder(reinterpret_cast<T *>(storage));
+            #else
+            return reinterpret_cast<T *>(storage);
+            #endif
+        }
+        const T *data() const noexcept {return const_cast<inline_vector *>(this)->data();}
+
+        T *begin() noexcept {return data();}
+        const T *begin() const noexcept {return data();}
+        T *end() noexcept {return data() + count;}
+        const T *end() const noexcept {return data() + count;}
+
+        T &operator[](detail::size_t i) noexcept {return data()[i];}
+        const T &operator[](detail::size_t i) const noexcept {return data()[i];}
+
+        // Constructs an element at the end. Stops the program with `BETTER_INIT_ABORT` if there's no space.
+        template <typename ...Q>
+        T &emplace_back(Q &&... params)
+        {
+            if (count == N)
+                detail::abort();
+            T *ret = ::new(static_cast<void *>(storage + sizeof(T) * count)) T(static_cast<Q &&>(params)...);
+            count++;
+            return *ret;
+        }
+
+        void pop_back() noexcept
+        {
+            T &elem = data()[count - 1];
+            count--;
+            elem.~T();
+        }
 
-            // `LegacyForwardIterator` requires us to return an actual reference here.
-            constexpr const Reference<T> &operator*() const noexcept {return *ref;}
+        void clear() noexcept
+        {
+            while (count > 0)
+                pop_back();
+        }
+    };
 
-            // No `operator->`. This causes C++20 `std::iterator_traits` to guess `pointer_type == void`, which sounds ok to me.
+    namespace custom
+    {
+        // `inline_vector` has no `std::initializer_list` constructor, but it should be initializable from lists implicitly.
+        template <typename T, detail::size_t N>
+        struct allow_implicit_init<inline_vector<T, N>> : std::true_type {};
+    }
 
-            // Don't want to rely on `<compare>`.
-            friend constexpr bool operator==(Iterator a, Iterator b) noexcept
+    namespace detail
+    {
+        // Whether `P...` is a single element that needs special handling when passed to `.emplace...()`: an `args_t` or a `lazy_t`.
+        template <typename ...P>
+        struct is_special_elem : std::integral_constant<bool, sizeof...(P) == 1 && (is_args<typename first_type<P..., void>::type>::value || is_lazy<typename first_type<P..., void>::type>::value)> {};
+
+        // Returns what should be passed to `.emplace...()` for a lazy element, for a container with the element type `T`.
+        // `.emplace...()` takes forwarding references, so a prvalue can only get through it as a conversion: if `func()` returns exactly `T`,
+        // we pass the element itself, and the container constructs `T` from the result of its conversion operator, without moves.
+        // Otherwise we call `func()` here, so that the constructors of `T` receive its result rather than our `lazy_t`.
+        template <typename T, typename U, std::enable_if_t<std::is_same<typename std::remove_reference_t<U>::result_type, T>::value, int> = 0>
+        constexpr U &&lazy_emplace_arg(U &&elem) noexcept
+        {
+            return static_cast<U &&>(elem);
+        }
+        template <typename T, typename U, std::enable_if_t<!std::is_same<typename std::remove_reference_t<U>::result_type, T>::value, int> = 0>
+        constexpr typename std::remove_reference_t<U>::result_type lazy_emplace_arg(U &&elem)
+        {
+            return elem.func();
+        }
+
+        // Calls `.emplace_back()` on a container for each element passed to it. `args_t` elements pass their arguments to it instead,
+        // and `lazy_t` elements are handled by `lazy_emplace_arg()`.
+        template <typename T>
+        struct emplace_back_func
+        {
+            T &container;
+
+            template <typename ...U, std::enable_if_t<!is_special_elem<U...>::value, int> = 0>
+            constexpr void operator()(U &&... elem) const
             {
-                return a.ref == b.ref;
+                container.emplace_back(static_cast<U &&>(elem)...);
             }
-            friend constexpr bool operator!=(Iterator a, Iterator b) noexcept
+            template <typename U, std::enable_if_t<is_args<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
             {
-                return !(a == b);
+                elem.apply(*this);
             }
-            friend constexpr bool operator<(Iterator a, Iterator b) noexcept
+            template <typename U, std::enable_if_t<is_lazy<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
             {
-                // Don't want to include `<functional>` for `std::less`, so need to cast to an integer to avoid UB.
-                return detail::uintptr_t(a.ref) < detail::uintptr_t(b.ref);
+                container.emplace_back(lazy_emplace_arg<typename custom::element_type<T>::type>(static_cast<U &&>(elem)));
             }
-            friend constexpr bool operator> (Iterator a, Iterator b) noexcept {return b < a;}
-            friend constexpr bool operator<=(Iterator a, Iterator b) noexcept {return !(b < a);}
-            friend constexpr bool operator>=(Iterator a, Iterator b) noexcept {return !(a < b);}
+        };
 
-            constexpr Iterator &operator++() noexcept
+        // Calls `.emplace()` on a container for each element passed to it, like `emplace_back_func`.
+        template <typename T>
+        struct emplace_func
+        {
+            T &container;
+
+            template <typename ...U, std::enable_if_t<!is_special_elem<U...>::value, int> = 0>
+            constexpr void operator()(U &&... elem) const
             {
-                ++ref;
-                return *this;
+                container.emplace(static_cast<U &&>(elem)...);
             }
-            constexpr Iterator &operator--() noexcept
+            template <typename U, std::enable_if_t<is_args<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
             {
-                --ref;
-                return *this;
+                elem.apply(*this);
             }
-            constexpr Iterator operator++(int) noexcept
+            template <typename U, std::enable_if_t<is_lazy<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
             {
-                Iterator ret = *this;
-                ++*this;
+                container.emplace(lazy_emplace_arg<typename custom::element_type<T>::type>(static_cast<U &&>(elem)));
+            }
+        };
+
+        // Whether `T` has `.reserve(n)`.
+        template <typename T, typename = void>
+        struct has_reserve : std::false_type {};
+        template <typename T>
+        struct has_reserve<T, decltype(void(declval<T &>().reserve(size_t{})))> : std::true_type {};
+
+        template <typename T>
+        constexpr void reserve_if_possible(std::true_type, T &container, size_t n) {container.reserve(n);}
+        template <typename T>
+        constexpr void reserve_if_possible(std::false_type, T &, size_t) {}
+
+        // The element factory for `custom::construct_sized` and `custom::append_sized`. `Iter` is one of our iterators.
+        template <typename Iter>
+        struct elem_factory
+        {
+            Iter begin;
+
+            constexpr decltype(auto) operator()(size_t i) const noexcept
+            {
+                return begin[ptrdiff_t(i)];
+            }
+        };
+
+        // Whether `custom::construct_sized` should be used to construct `T`, instead of `custom::construct`.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_construct_sized : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct use_construct_sized<std::enable_if_t<std::is_base_of<IteratorBase, Iter>::value && std::is_convertible<decltype(custom::construct_sized<void, T, Iter::list_size, elem_factory<Iter>, P...>{}(declval<elem_factory<Iter>>(), declval<P &&>()...)), T>::value>, T, Iter, P...>
+            : std::true_type
+        {};
+
+        // Whether `Iter` is one of our iterators, over a list that has nested lists in it.
+        template <typename Iter, typename = void>
+        struct has_nested_lists : std::false_type {};
+        template <typename Iter>
+        struct has_nested_lists<Iter, std::enable_if_t<Iter::has_nested_lists>> : std::true_type {};
+
+        // Whether `T` should be constructed by calling `.emplace_back()` for each element, rather than from a pair of iterators.
+        // We require the element type to be movable, because `.emplace_back()` might need to reallocate. Non-movable types use the iterators.
+        // We also require `T` to be constructible from the iterators, to make sure we don't change the meaning of the extra arguments.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_emplace_back : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct use_emplace_back<decltype(void(declval<T &>().emplace_back(*declval<Iter &>()))), T, Iter, P...>
+            : std::integral_constant<bool,
+                std::is_base_of<IteratorBase, Iter>::value &&
+                std::is_constructible<T, Iter, Iter, P...>::value &&
+                std::is_constructible<T, P...>::value &&
+                std::is_move_constructible<T>::value &&
+                std::is_move_constructible<typename custom::element_type<T>::type>::value &&
+                !use_construct_sized<void, T, Iter, P...>::value
+                #if BETTER_INIT_ALLOCATOR_HACK
+                // With the allocator hack, nested lists are constructed in place only when constructing from the iterators.
+                && !(has_nested_lists<Iter>::value && allocator_hack::has_replaceable_allocator<T>::value)
+                #endif
+            >
+        {};
+    }
+
+    namespace detail
+    {
+        // Whether `T` is an unordered container (has `.bucket_count()` and `.reserve()`) that should be constructed by calling `.emplace()` for each element,
+        // rather than from a pair of iterators. Unlike `use_emplace_back`, this doesn't need the elements to be movable.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_unordered_emplace : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct use_unordered_emplace<void_t<decltype(declval<const T &>().bucket_count()), decltype(declval<T &>().reserve(size_t{})), decltype(declval<T &>().emplace(*declval<Iter &>()))>, T, Iter, P...>
+            : std::integral_constant<bool,
+                std::is_base_of<IteratorBase, Iter>::value &&
+                std::is_constructible<T, Iter, Iter, P...>::value &&
+                std::is_constructible<T, P...>::value &&
+                std::is_move_constructible<T>::value &&
+                !use_emplace_back<void, T, Iter, P...>::value &&
+                !use_construct_sized<void, T, Iter, P...>::value
+            >
+        {};
+    }
+
+    namespace detail
+    {
+        // Constructs `T` from the iterators, for `custom::construct`.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct default_construct
+        {
+            template <typename TT = T, std::enable_if_t<std::is_constructible<TT, Iter, Iter, P...>::value, int> = 0>
+            constexpr T operator()(Iter begin, Iter end, P &&... params) const noexcept(std::is_nothrow_constructible<T, Iter, Iter, P...>::value)
+            {
+                hook<hook_event::construct_container, T>();
+                return T(static_cast<Iter &&>(begin), static_cast<Iter &&>(end), static_cast<P &&>(params)...);
+            }
+        };
+
+        // Dispatches to `custom::construct_sized`, if it's specialized for `T`.
+        template <typename T, typename Iter, typename ...P>
+        struct default_construct<std::enable_if_t<use_construct_sized<void, T, Iter, P...>::value>, T, Iter, P...>
+        {
+            using factory = elem_factory<Iter>;
+
+            constexpr T operator()(Iter begin, Iter, P &&... params) const
+            noexcept(noexcept(custom::construct_sized<void, T, Iter::list_size, factory, P...>{}(declval<factory>(), declval<P &&>()...)))
+            {
+                hook<hook_event::construct_container, T>();
+                return custom::construct_sized<void, T, Iter::list_size, factory, P...>{}(factory{begin}, static_cast<P &&>(params)...);
+            }
+        };
+
+        // Containers with `.emplace_back()` (such as `std::vector` and `std::deque`) are constructed by emplacing every element, after `.reserve()`-ing if possible.
+        // This constructs each element directly from its original type, bypassing `Reference` and the function pointer tables.
+        template <typename T, typename Iter, typename ...P>
+        struct default_construct<std::enable_if_t<use_emplace_back<void, T, Iter, P...>::value>, T, Iter, P...>
+        {
+            constexpr T operator()(Iter begin, Iter end, P &&... params) const
+            {
+                hook<hook_event::construct_container, T>();
+                T ret(static_cast<P &&>(params)...);
+                reserve_if_possible(has_reserve<T>{}, ret, size_t(end - begin));
+                begin.for_each_elem(emplace_back_func<T>{ret});
                 return ret;
             }
-            constexpr Iterator operator--(int) noexcept
+        };
+
+        // Unordered containers (such as `std::unordered_map`) are constructed by `.reserve()`-ing the final size, to avoid rehashing, then emplacing every element.
+        // Each element is constructed directly from its original type. E.g. for maps, a `std::pair<A, B>` element constructs the key from `A` and the value from `B`,
+        // without a temporary `value_type`.
+        template <typename T, typename Iter, typename ...P>
+        struct default_construct<std::enable_if_t<use_unordered_emplace<void, T, Iter, P...>::value>, T, Iter, P...>
+        {
+            constexpr T operator()(Iter begin, Iter end, P &&... params) const
             {
-                Iterator ret = *this;
-                --*this;
+                hook<hook_event::construct_container, T>();
+                T ret(static_cast<P &&>(params)...);
+                ret.reserve(size_t(end - begin));
+                begin.for_each_elem(emplace_func<T>{ret});
                 return ret;
             }
-            constexpr friend Iterator operator+(Iterator it, detail::ptrdiff_t n) noexcept {it += n; return it;}
-            constexpr friend Iterator operator+(detail::ptrdiff_t n, Iterator it) noexcept {it += n; return it;}
-            constexpr friend Iterator operator-(Iterator it, detail::ptrdiff_t n) noexcept {it -= n; return it;}
-            // There's no `number - iterator`.
+        };
+    }
+
+    namespace detail
+    {
+        // Whether `T` is a C++23 flat container that accepts `std::sorted_unique` or `std::sorted_equivalent`, in that order of preference.
+        // If so, `type` is that tag type, and `unique` is true for the former.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct flat_sorted_tag {};
+        #if BETTER_INIT_FLAT_CONTAINERS
+        template <typename T, typename Iter, typename ...P>
+        struct flat_sorted_tag<std::enable_if_t<std::is_constructible<T, std::sorted_unique_t, Iter, Iter, P...>::value>, T, Iter, P...>
+        {
+            using type = std::sorted_unique_t;
+            static constexpr bool unique = true;
+        };
+        template <typename T, typename Iter, typename ...P>
+        struct flat_sorted_tag<std::enable_if_t<!std::is_constructible<T, std::sorted_unique_t, Iter, Iter, P...>::value && std::is_constructible<T, std::sorted_equivalent_t, Iter, Iter, P...>::value>, T, Iter, P...>
+        {
+            using type = std::sorted_equivalent_t;
+            static constexpr bool unique = false;
+        };
+        #endif
+
+        // Whether `flat_sorted_tag` is defined for `T`.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct has_flat_sorted_tag : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct has_flat_sorted_tag<void_t<typename flat_sorted_tag<void, T, Iter, P...>::type>, T, Iter, P...> : std::true_type {};
 
-            constexpr friend detail::ptrdiff_t operator-(Iterator a, Iterator b) noexcept {return a.ref - b.ref;}
+        // Whether `T` should be constructed from sorted elements by calling `.emplace_hint(end, elem)` for each element.
+        // This is the case for node-based ordered containers, such as `std::map` and `std::set`.
+        template <typename Void, typename T, typename Iter, typename ...P>
+        struct use_sorted_emplace_hint : std::false_type {};
+        template <typename T, typename Iter, typename ...P>
+        struct use_sorted_emplace_hint<decltype(void(declval<T &>().emplace_hint(declval<T &>().end(), *declval<Iter &>()))), T, Iter, P...>
+            : std::integral_constant<bool,
+                std::is_base_of<IteratorBase, Iter>::value &&
+                std::is_constructible<T, P...>::value &&
+                std::is_move_constructible<T>::value
+            >
+        {};
+
+        // Calls `.emplace_hint(end, elem)` on a container for each element passed to it. `lazy_t` elements are handled by `lazy_emplace_arg()`.
+        // With `BETTER_INIT_CHECK_SORTED`, checks that each element ends up last, which means the elements are sorted.
+        template <typename T>
+        struct emplace_hint_func
+        {
+            T &container;
 
-            constexpr Iterator &operator+=(detail::ptrdiff_t n) noexcept {ref += n; return *this;}
-            constexpr Iterator &operator-=(detail::ptrdiff_t n) noexcept {ref -= n; return *this;}
+            template <typename U, std::enable_if_t<!is_lazy<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
+            {
+                emplace_last(static_cast<U &&>(elem));
+            }
+            template <typename U, std::enable_if_t<is_lazy<U>::value, int> = 0>
+            constexpr void operator()(U &&elem) const
+            {
+                emplace_last(lazy_emplace_arg<typename custom::element_type<T>::type>(static_cast<U &&>(elem)));
+            }
 
-            constexpr const Reference<T> &operator[](detail::ptrdiff_t i) const noexcept
+          private:
+            template <typename U>
+            constexpr void emplace_last(U &&elem) const
             {
-                return *(*this + i);
+                #if BETTER_INIT_CHECK_SORTED
+                auto it = container.emplace_hint(container.end(), static_cast<U &&>(elem));
+                if (++it != container.end())
+                    abort();
+                #else
+                container.emplace_hint(container.end(), static_cast<U &&>(elem));
+                #endif
             }
         };
 
-        // Could use `std::array`, but want to use less headers.
-        // Could use `[[no_unique_address]]`, but it's our only member variable anyway.
-        // Can't store `Reference`s here directly, because we can't use a templated `operator T` in our elements,
-        // because it doesn't work correctly on MSVC (but not on GCC and Clang).
-        std::conditional_t<sizeof...(P) == 0, detail::empty, void *[sizeof...(P) + (sizeof...(P) == 0)]> elems;
+        // Whether the elements of `container` are sorted according to its `.value_comp()`, and unique if `unique` is true.
+        template <typename T>
+        constexpr bool is_sorted_container(const T &container, bool unique)
+        {
+            auto comp = container.value_comp();
+            auto it = container.begin();
+            auto end = container.end();
+            if (it == end)
+                return true;
+            for (auto next = it; ++next != end; it = next)
+            {
+                if (unique ? !comp(*it, *next) : bool(comp(*next, *it)))
+                    return false;
+            }
+            return true;
+        }
+    }
 
-      public:
-        // Whether this list can be used to initialize a range type `T`, with extra constructor parameters `P...`.
-        template <typename T, typename ...Q> static constexpr bool can_initialize_range         = detail::constructible_from_iters        <T, Iterator<typename custom::element_type<T>::type>, Q...>::value && can_initialize_elem        <typename custom::element_type<T>::type>;
-        template <typename T, typename ...Q> static constexpr bool can_nothrow_initialize_range = detail::nothrow_constructible_from_iters<T, Iterator<typename custom::element_type<T>::type>, Q...>::value && can_nothrow_initialize_elem<typename custom::element_type<T>::type>;
+    namespace custom
+    {
+        // Node-based ordered containers are constructed by emplacing every element at the end, which is an amortized constant time operation if they're sorted.
+        // Each element is constructed directly from its original type, like in `use_emplace_back`.
+        template <typename T, typename Iter, typename ...P>
+        struct construct_sorted<std::enable_if_t<detail::use_sorted_emplace_hint<void, T, Iter, P...>::value && !detail::has_flat_sorted_tag<void, T, Iter, P...>::value>, T, Iter, P...>
+        {
+            constexpr T operator()(Iter begin, Iter, P &&... params) const
+            {
+                detail::hook<hook_event::construct_container, T>();
+                T ret(static_cast<P &&>(params)...);
+                begin.for_each_elem(detail::emplace_hint_func<T>{ret});
+                return ret;
+            }
+        };
 
-        // The constructor from a braced (or parenthesized) list.
-        // No `[[nodiscard]]` because GCC 9 complains. Having it on the entire class should be enough.
-        constexpr DETAIL_BETTER_INIT_CLASS_NAME(P &&... params) noexcept
-            : elems{const_cast<void *>(static_cast<const void *>(&params))...}
-        {}
+        #if BETTER_INIT_FLAT_CONTAINERS
+        // Flat containers are constructed with `std::sorted_unique` or `std::sorted_equivalent`, which skips sorting them.
+        template <typename T, typename Iter, typename ...P>
+        struct construct_sorted<std::enable_if_t<detail::has_flat_sorted_tag<void, T, Iter, P...>::value>, T, Iter, P...>
+        {
+            using tag = detail::flat_sorted_tag<void, T, Iter, P...>;
 
-        // The conversion functions below are `&&`-qualified as a reminder that your initializer elements can be dangling.
+            constexpr T operator()(Iter begin, Iter end, P &&... params) const
+            {
+                detail::hook<hook_event::construct_container, T>();
+                T ret(typename tag::type{}, static_cast<Iter &&>(begin), static_cast<Iter &&>(end), static_cast<P &&>(params)...);
+                #if BETTER_INIT_CHECK_SORTED
+                if (!detail::is_sorted_container(ret, tag::unique))
+                    detail::abort();
+                #endif
+                return ret;
+            }
+        };
+        #endif
+    }
 
-        // Implicit conversion to a container. Implicit-ness is only enabled when it has a `std::initializer_list` constructor.
-        template <typename T, std::enable_if_t<can_initialize_range<T> && custom::allow_implicit_init<T>::value, int> = 0>
-        BETTER_INIT_NODISCARD constexpr operator T() const && noexcept(can_nothrow_initialize_range<T>)
+    namespace detail
+    {
+        // The number of elements in a part of `better_init::concat()`: a list, a range with `.size()`, or an array.
+        template <typename T, std::enable_if_t<is_list<T>::value, int> = 0>
+        constexpr size_t concat_part_size(const T &) noexcept
         {
-            // Don't want to include `<utility>` for `std::move`.
-            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+            return T::size();
         }
-        // Explicit conversion to a container.
-        template <typename T, std::enable_if_t<can_initialize_range<T>, int> = 0>
-        BETTER_INIT_NODISCARD constexpr explicit operator T() const && noexcept(can_nothrow_initialize_range<T>)
+        template <typename T, std::enable_if_t<!is_list<T>::value, int> = 0>
+        constexpr size_t concat_part_size(const T &range)
         {
-            // Don't want to include `<utility>` for `std::move`.
-            return static_cast<const DETAIL_BETTER_INIT_CLASS_NAME &&>(*this).to<T>();
+            return size_t(range.size());
         }
-
-        // Conversion to a container with extra arguments (such as an allocator).
-        template <typename T, typename ...Q, std::enable_if_t<can_initialize_range<T, Q...> && sizeof...(P) == 0, int> = 0>
-        BETTER_INIT_NODISCARD constexpr T to(Q &&... extra_args) const && noexcept(can_nothrow_initialize_range<T, Q...>)
+        template <typename T, size_t N>
+        constexpr size_t concat_part_size(T (&)[N]) noexcept
         {
-            using elem_type = typename custom::element_type<T>::type;
-            return custom::construct<void, T, Iterator<elem_type>, Q...>{}(Iterator<elem_type>{}, Iterator<elem_type>{}, static_cast<Q &&>(extra_args)...);
+            return N;
         }
-        // Conversion to a container with extra arguments (such as an allocator).
-        template <typename T, typename ...Q, std::enable_if_t<can_initialize_range<T, Q...> && sizeof...(P) != 0, int> = 0>
-        BETTER_INIT_NODISCARD constexpr T to(Q &&... extra_args) const && noexcept(can_nothrow_initialize_range<T, Q...>)
+
+        // Returns the total number of elements in the parts passed to it.
+        struct concat_size_func
         {
-            using elem_type = typename custom::element_type<T>::type;
+            template <typename ...U>
+            constexpr size_t operator()(const U &... parts) const
+            {
+                size_t ret = 0;
+                (void)expand_pack{0, (void(ret += concat_part_size(parts)), 0)...};
+                return ret;
+            }
+        };
 
-            // Could use `std::array`, but want to use less headers.
-            // Must store `Reference`s here, because `std::random_access_iterator` requires `operator[]` to return the same type as `operator*`,
-            // and `LegacyForwardIterator` requires `operator*` to return an actual reference. If we don't have those here, we don't have anything for the references to point to.
-            Reference<elem_type> refs[sizeof...(P)];
-            for (detail::size_t i = 0; i < sizeof...(P); i++)
+        // Emplaces the elements of a list at the end of `container`, passing them as is, like `use_emplace_back`.
+        template <typename T>
+        struct concat_list_func
+        {
+            T &container;
+
+            template <typename Iter>
+            constexpr void operator()(Iter begin, Iter) const
+            {
+                begin.for_each_elem(emplace_back_func<T>{container});
+            }
+        };
+
+        // Emplaces the elements of each part passed to it at the end of `container`. Lvalue ranges are copied, and rvalue ranges are moved from.
+        template <typename T>
+        struct concat_append_func
+        {
+            T &container;
+
+            // Lvalue lists are accepted too, and behave like rvalues: the list doesn't own the elements, and passes each one as it was given.
+            template <typename U, std::enable_if_t<is_list<U>::value, int> = 0>
+            constexpr void append(U &&list) const
+            {
+                static_cast<const std::remove_reference_t<U> &&>(list).template with_iterators<typename custom::element_type<T>::type>(concat_list_func<T>{container});
+            }
+            template <typename U, std::enable_if_t<!is_list<U>::value, int> = 0>
+            constexpr void append(U &&range) const
+            {
+                for (auto &&elem : range)
+                {
+                    using elem_type = std::conditional_t<std::is_lvalue_reference<U>::value, decltype(elem), std::remove_reference_t<decltype(elem)> &&>;
+                    container.emplace_back(static_cast<elem_type>(elem));
+                }
+            }
+
+            template <typename ...U>
+            constexpr void operator()(U &&... parts) const
             {
-                refs[i].target = elems[i];
-                refs[i].index = i;
+                (void)expand_pack{0, (append(static_cast<U &&>(parts)), 0)...};
             }
+        };
+
+        // Dereferences an iterator of a range part of `better_init::concat()`. Only used in `decltype`.
+        template <typename U>
+        auto concat_range_deref(U &range) -> decltype(*range.begin());
+        template <typename U, size_t N>
+        U &concat_range_deref(U (&range)[N]);
+
+        // Whether the elements of a part `U` of `better_init::concat()` can be emplaced into a container with the element type `E`.
+        // For ranges, this uses the same reference type as `concat_append_func`.
+        template <typename Void, typename E, typename U>
+        struct concat_part_constructible : std::false_type {};
+        template <typename E, typename U>
+        struct concat_part_constructible<std::enable_if_t<is_list<U>::value>, E, U>
+            : std::integral_constant<bool, std::remove_cv_t<std::remove_reference_t<U>>::template can_initialize_elem<E>>
+        {};
+        template <typename E, typename U>
+        struct concat_part_constructible<std::enable_if_t<!is_list<U>::value, void_t<decltype(concat_range_deref(declval<std::remove_reference_t<U> &>()))>>, E, U>
+            : std::is_constructible<E, std::conditional_t<std::is_lvalue_reference<U>::value,
+                decltype(concat_range_deref(declval<U &>())) &&,
+                std::remove_reference_t<decltype(concat_range_deref(declval<U &>()))> &&
+            >>
+        {};
+
+        // Whether `better_init::concat()` with the parts `type_list<U...>` can initialize `T`, passing `Q...` to its constructor.
+        template <typename Void, typename T, typename L, typename ...Q>
+        struct concat_constructible : std::false_type {};
+        template <typename T, typename ...U, typename ...Q>
+        struct concat_constructible<void_t<decltype(declval<T &>().emplace_back(declval<typename custom::element_type<T>::type>()))>, T, type_list<U...>, Q...>
+            : std::integral_constant<bool, std::is_constructible<T, Q...>::value && all_of({concat_part_constructible<void, typename custom::element_type<T>::type, U>::value...})>
+        {};
+    }
+
+    // The result of `better_init::concat()`. Remembers its parts by reference, like the list class.
+    template <typename ...P>
+    class BETTER_INIT_NODISCARD concat_t
+    {
+        detail::arg_refs<detail::make_index_sequence<sizeof...(P)>, P...> parts;
+
+      public:
+        constexpr concat_t(P &&... params) noexcept : parts(params...) {}
 
-            Iterator<elem_type> begin, end;
-            begin.ref = refs;
-            end.ref = refs + sizeof...(P);
+        // Whether this can be converted to `T` with the extra arguments `Q...`.
+        template <typename T, typename ...Q> static constexpr bool can_initialize = detail::concat_constructible<void, T, detail::type_list<P...>, Q...>::value;
+
+        // The total number of elements.
+        BETTER_INIT_NODISCARD constexpr detail::size_t size() const
+        {
+            return parts.apply(detail::concat_size_func{});
+        }
+
+        // Implicit conversion to a container. Implicit-ness is enabled in the same cases as for the list class, see `custom::allow_implicit_init`.
+        template <typename T, std::enable_if_t<can_initialize<T> && custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr operator T() const &&
+        {
+            return static_cast<const concat_t &&>(*this).to<T>();
+        }
+        // Explicit conversion to a container.
+        template <typename T, std::enable_if_t<can_initialize<T> && !custom::allow_implicit_init<T>::value, int> = 0>
+        BETTER_INIT_NODISCARD constexpr explicit operator T() const &&
+        {
+            return static_cast<const concat_t &&>(*this).to<T>();
+        }
 
-            return custom::construct<void, T, Iterator<elem_type>, Q...>{}(begin, end, static_cast<Q &&>(extra_args)...);
+        // Conversion to a container with extra arguments (such as an allocator).
+        // The container is constructed from `extra_args...`, reserves space for all elements if it can, then they are emplaced one by one.
+        template <typename T, typename ...Q, std::enable_if_t<can_initialize<T, Q...>, int> = 0>
+        BETTER_INIT_NODISCARD constexpr T to(Q &&... extra_args) const &&
+        {
+            detail::hook<hook_event::construct_container, T>();
+            T ret(static_cast<Q &&>(extra_args)...);
+            detail::reserve_if_possible(detail::has_reserve<T>{}, ret, size());
+            parts.apply(detail::concat_append_func<T>{ret});
+            return ret;
         }
     };
 
-    #if BETTER_INIT_ALLOW_BRACES
-    // A deduction guide for the list class.
-    template <typename ...P>
-    DETAIL_BETTER_INIT_CLASS_NAME(P &&...) -> DETAIL_BETTER_INIT_CLASS_NAME<P...>;
-    #else
-    // A helper function to construct the list class.
+    // Concatenates lists and ranges into a single container, e.g. `std::vector<T> v = better_init::concat(init{...}, range, init{...});`.
+    // The total size is computed in advance, so vector-like containers allocate only once. Each element is constructed once, directly in the container.
+    // The list elements are passed to `.emplace_back()` as is, like when constructing a vector from a list. The elements of lvalue ranges are copied,
+    // and those of rvalue ranges are moved. The ranges must have `.size()`, or be arrays. The lists can be lvalues too, this doesn't change how their elements are passed.
     template <typename ...P>
-    BETTER_INIT_NODISCARD constexpr DETAIL_BETTER_INIT_CLASS_NAME<P...> BETTER_INIT_IDENTIFIER(P &&... params) noexcept
+    BETTER_INIT_NODISCARD constexpr concat_t<P...> concat(P &&... parts) noexcept
     {
-        return DETAIL_BETTER_INIT_CLASS_NAME<P...>(static_cast<P &&>(params)...);
+        return concat_t<P...>(static_cast<P &&>(parts)...);
     }
-    #endif
 }
 
 using better_init::BETTER_INIT_IDENTIFIER;
@@ -496,6 +2847,13 @@ using better_init::BETTER_INIT_IDENTIFIER;
 // See the macro definition for details.
 #if BETTER_INIT_ALLOCATOR_HACK
 
+// The type of the constant template parameter, when matching templates like `small_vector<T, N, Alloc>` to replace their allocator.
+#if BETTER_INIT_CXX_STANDARD >= 17
+#define DETAIL_BETTER_INIT_CONSTANT_PARAM auto
+#else
+#define DETAIL_BETTER_INIT_CONSTANT_PARAM size_t
+#endif
+
 namespace better_init
 {
     namespace detail
@@ -530,10 +2888,20 @@ namespace better_init
             > : std::true_type {};
 
             // Whether `T` has an allocator template argument, satisfying `is_replaceable_allocator`.
-            template <typename T, typename = void>
-            struct has_replaceable_allocator : std::false_type {};
-            template <template <typename...> class T, typename ...P, typename Void>
-            struct has_replaceable_allocator<T<P...>, Void> : std::integral_constant<bool, any_of({is_replaceable_allocator<P>::value...})> {};
+            template <typename T>
+            struct has_replaceable_allocator_argument : std::false_type {};
+            template <template <typename...> class T, typename ...P>
+            struct has_replaceable_allocator_argument<T<P...>> : std::integral_constant<bool, any_of({is_replaceable_allocator<P>::value...})> {};
+            template <template <typename, DETAIL_BETTER_INIT_CONSTANT_PARAM, typename...> class T, typename A, DETAIL_BETTER_INIT_CONSTANT_PARAM N, typename ...P>
+            struct has_replaceable_allocator_argument<T<A, N, P...>> : std::integral_constant<bool, any_of({is_replaceable_allocator<A>::value, is_replaceable_allocator<P>::value...})> {};
+
+            // Whether we can replace the allocator of `T`, either using `custom::rebind_allocator` or by replacing its template arguments.
+            template <typename T, typename>
+            struct has_replaceable_allocator : has_replaceable_allocator_argument<T> {};
+            template <typename T>
+            struct has_replaceable_allocator<T, void_t<typename custom::rebind_allocator<T>::allocator_type>>
+                : is_replaceable_allocator<typename custom::rebind_allocator<T>::allocator_type>
+            {};
 
             // If T satisfies `is_replaceable_allocator`, return our `modified_allocator` for it. Otherwise return `T` unchanged.
             template <typename T, typename = void>
@@ -541,11 +2909,20 @@ namespace better_init
             template <typename T>
             struct replace_allocator_type<T, std::enable_if_t<is_replaceable_allocator<T>::value>> {using type = modified_allocator<T>;};
 
-            // Apply `replace_allocator_type` to each template argument of `T`.
+            // Apply `replace_allocator_type` to each template argument of `T`, or to the allocator specified by `custom::rebind_allocator`.
+            template <typename T>
+            struct substitute_allocator_argument {using type = T;};
+            template <template <typename...> class T, typename ...P>
+            struct substitute_allocator_argument<T<P...>> {using type = T<typename replace_allocator_type<P>::type...>;};
+            template <template <typename, DETAIL_BETTER_INIT_CONSTANT_PARAM, typename...> class T, typename A, DETAIL_BETTER_INIT_CONSTANT_PARAM N, typename ...P>
+            struct substitute_allocator_argument<T<A, N, P...>> {using type = T<typename replace_allocator_type<A>::type, N, typename replace_allocator_type<P>::type...>;};
             template <typename T, typename = void>
-            struct substitute_allocator {using type = T;};
-            template <template <typename...> class T, typename ...P, typename Void>
-            struct substitute_allocator<T<P...>, Void> {using type = T<typename replace_allocator_type<P>::type...>;};
+            struct substitute_allocator : substitute_allocator_argument<T> {};
+            template <typename T>
+            struct substitute_allocator<T, void_t<typename custom::rebind_allocator<T>::allocator_type>>
+            {
+                using type = typename custom::rebind_allocator<T>::template rebind<typename replace_allocator_type<typename custom::rebind_allocator<T>::allocator_type>::type>;
+            };
 
             // Whether `T` is a reference class. If it's used as a `.construct()` parameter, we wrap this call.
             template <typename T>
@@ -556,6 +2933,17 @@ namespace better_init
             struct should_wrap_construction : std::false_type {};
             template <typename T, typename Ref>
             struct should_wrap_construction<std::enable_if_t<is_reference_class<std::remove_cv_t<std::remove_reference_t<Ref>>>::value>, T, Ref> : std::true_type {};
+            // Nested lists are wrapped too, if the target container has an allocator we can replace. This constructs the inner container in place.
+            template <typename T, typename List>
+            struct should_wrap_construction<
+                std::enable_if_t<
+                    is_list<List>::value &&
+                    !std::is_reference<List>::value &&
+                    has_replaceable_allocator<typename std::allocator_traits<T>::value_type>::value &&
+                    List::template can_initialize_range<typename std::allocator_traits<T>::value_type>
+                >,
+                T, List
+            > : std::true_type {};
 
             template <typename Base>
             struct modified_allocator : Base
@@ -570,6 +2958,11 @@ namespace better_init
                 // Solely for convenience. The rest of typedefs are inherited.
                 using value_type = typename std::allocator_traits<Base>::value_type;
 
+                // This inherits the converting constructors, which are needed for rebinding.
+                using Base::Base;
+                constexpr modified_allocator() = default;
+                constexpr modified_allocator(const Base &base) noexcept : Base(base) {}
+
                 // This is called by `construct()` if no workaround is needed.
                 // Interestingly, clang complains if those are defined below `construct()`. Probably because they're mentioned in its `noexcept` specification.
                 template <typename ...P>
@@ -594,6 +2987,24 @@ namespace better_init
                     construct_low(should_wrap_construction<void, Base, P...>{}, ptr, static_cast<P &&>(params)...);
                 }
             };
+
+            template <typename A, typename T>
+            struct construct_container_at_func
+            {
+                A &alloc;
+                T *target;
+
+                template <typename Iter>
+                constexpr void operator()(Iter begin, Iter end) const
+                {
+                    // Same as in `custom::construct` below, the container is constructed with our allocator and is then aliased to the original type.
+                    using fixed_container = typename substitute_allocator<T>::type;
+                    static_assert(sizeof(fixed_container) == sizeof(T) && alignof(fixed_container) == alignof(T), "Internal error: Our custom allocator has a wrong size or alignment.");
+                    using rebound = typename std::allocator_traits<A>::template rebind_alloc<fixed_container>;
+                    rebound fixed_alloc(alloc);
+                    std::allocator_traits<rebound>::construct(fixed_alloc, reinterpret_cast<fixed_container *>(target), static_cast<Iter &&>(begin), static_cast<Iter &&>(end));
+                }
+            };
         }
     }
 
@@ -602,7 +3013,12 @@ namespace better_init
         template <typename T, typename Iter, typename ...P>
         struct construct<
             std::enable_if_t<
-                detail::allocator_hack::has_replaceable_allocator<T>::value
+                // Not needed if the iterator points to ready elements (e.g. packed ones), which are simply copied.
+                !std::is_same<std::remove_cv_t<std::remove_reference_t<decltype(*detail::declval<Iter &>())>>, typename element_type<T>::type>::value &&
+                detail::allocator_hack::has_replaceable_allocator<T>::value &&
+                !detail::use_emplace_back<void, T, Iter, P...>::value &&
+                !detail::use_unordered_emplace<void, T, Iter, P...>::value &&
+                !detail::use_construct_sized<void, T, Iter, P...>::value
             >,
             T, Iter, P...
         >
@@ -611,11 +3027,14 @@ namespace better_init
 
             using fixed_container = typename detail::allocator_hack::substitute_allocator<T>::type;
 
+            // SFINAE-friendly, so that `can_initialize_range` doesn't fail with a hard error when the extra arguments don't fit.
+            template <typename C = fixed_container, std::enable_if_t<detail::constructible_from_iters<C, Iter, P...>::value, int> = 0>
             constexpr T operator()(Iter begin, Iter end, P &&... params) const
             noexcept(noexcept(construct<void, fixed_container, Iter, P...>{}(detail::declval<Iter &&>(), detail::declval<Iter &&>(), detail::declval<P &&>()...)))
             {
                 // Note that we intentionally `reinterpret_cast` (which requires `may_alias` and all that),
                 // rather than memcpy-ing into the proper type. That's because the container might remember its own address.
+                detail::hook<hook_event::allocator_hack, T>();
                 struct BETTER_INIT_ALLOCATOR_HACK_MAY_ALIAS alias_from {fixed_container value;};
                 alias_from ret{construct<void, fixed_container, Iter, P...>{}(static_cast<Iter &&>(begin), static_cast<Iter &&>(end), static_cast<P &&>(params)...)};
                 struct BETTER_INIT_ALLOCATOR_HACK_MAY_ALIAS alias_to {T value;};
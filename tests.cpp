@@ -1,19 +1,43 @@
 #ifndef BETTER_INIT_CONFIG // This lets us run tests on godbolt easier, see below.
+// Count the instrumentation events, see the tests below.
+#define HAVE_HOOKS 1
+namespace better_init {enum class hook_event;}
+void count_hook_event(better_init::hook_event event);
+#define BETTER_INIT_HOOK(event, ...) if (!__builtin_is_constant_evaluated()) count_hook_event(event)
 #include "better_init.hpp"
+#else
+#define HAVE_HOOKS 0
 #endif
 
 // To run on https://gcc.godbolt.org, copy-paste following:
 // #include <https://raw.githubusercontent.com/HolyBlackCat/better_init/master/include/better_init.hpp>
 // #include <https://raw.githubusercontent.com/HolyBlackCat/better_init/master/include/tests.cpp>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <deque>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if BETTER_INIT_CXX_STANDARD >= 20 && __has_include(<ranges>)
+#include <ranges>
+#endif
+
+#if BETTER_INIT_CXX_STANDARD >= 17 && __has_include(<memory_resource>)
+#define HAVE_MEMORY_RESOURCE 1
+#include <memory_resource>
+#else
+#define HAVE_MEMORY_RESOURCE 0
+#endif
 
 // Expands to the preferred init list notation for the current language standard.
 #if BETTER_INIT_ALLOW_BRACES
@@ -82,7 +106,7 @@ better_init::DETAIL_BETTER_INIT_CLASS_NAME<P...> &&invalid_init_list()
 #define CHECKED_LIST_TYPES(X) \
     /* Target type         | Element types... */\
     X(int,                  ) \
-    X(int,                  int, int) \
+    X(int,                  int &&, int &&) /* Not prvalues, because then the list is packed, and has no iterators. */ \
     X(int,                  int, const int, int &, const int &) \
     X(std::unique_ptr<int>, std::nullptr_t &, std::unique_ptr<int>) \
 
@@ -107,6 +131,7 @@ struct IteratorCategoryChecker
         static_assert(std::random_access_iterator<U>, "The iterator concept wasn't satisfied.");
         #endif
         static_assert(std::is_same<typename std::iterator_traits<U>::iterator_category, std::random_access_iterator_tag>::value, "Wrong iterator category.");
+        static_assert(std::is_reference<decltype(*std::declval<U>())>::value == !BETTER_INIT_PROXY_ITERATORS, "Proxy iterators must return references by value.");
     }
 };
 #define CHECK_ITERATOR_CATEGORY(target_, ...) (void)IteratorCategoryChecker<target_>(invalid_init_list<__VA_ARGS__>());
@@ -124,8 +149,10 @@ struct IteratorSanityChecker
 {
     using value_type = int;
 
+    bool from_pointers = false;
+
     template <typename T>
-    IteratorSanityChecker(T begin, T end)
+    IteratorSanityChecker(T begin, T end) : from_pointers(std::is_pointer<T>::value)
     {
         { // Increments and decrements.
             auto iter = begin;
@@ -201,13 +228,397 @@ struct ContainerWithForcedArgs
     template <typename T>
     ContainerWithForcedArgs(T, T, int, int, int) {}
 };
+// A fake container with `.emplace_back()`, records how it was constructed.
+struct ContainerWithEmplaceBack
+{
+    using value_type = int;
+
+    std::size_t reserved = 0;
+    std::string emplaced; // `l` for lvalues, `r` for rvalues.
+    bool from_iters = false;
+
+    ContainerWithEmplaceBack() {}
+    template <typename T>
+    ContainerWithEmplaceBack(T, T) : from_iters(true) {}
+
+    void reserve(std::size_t n) {reserved = n;}
+
+    template <typename T>
+    void emplace_back(T &&)
+    {
+        emplaced += std::is_lvalue_reference<T>::value ? 'l' : 'r';
+    }
+};
+
+// A fake unordered container, records how it was constructed.
+struct UnorderedContainerWithEmplace
+{
+    using value_type = int;
+
+    std::size_t reserved = 0;
+    std::size_t emplaced = 0;
+    bool from_iters = false;
+
+    UnorderedContainerWithEmplace() {}
+    template <typename T>
+    UnorderedContainerWithEmplace(T, T) : from_iters(true) {}
+
+    std::size_t bucket_count() const {return 1;}
+    void reserve(std::size_t n) {reserved = n;}
+
+    template <typename T>
+    void emplace(T &&)
+    {
+        ASSERT(reserved != 0); // Must reserve first.
+        emplaced++;
+    }
+};
+
+// A vector that counts how many times it was moved, to check that nested lists construct the inner containers in place.
+int move_counting_vector_moves = 0;
+template <typename T, typename A = std::allocator<T>>
+struct MoveCountingVector : std::vector<T, A>
+{
+    using std::vector<T, A>::vector;
+    MoveCountingVector() {}
+    MoveCountingVector(MoveCountingVector &&other) noexcept : std::vector<T, A>(std::move(other)) {move_counting_vector_moves++;}
+};
+
+// A fake container that wants the size in advance, see the `custom::construct_sized` specialization below.
+// Also has a constructor from iterators and `.emplace_back()`, which shouldn't be used.
+struct ContainerWithSizedCtor
+{
+    using value_type = std::unique_ptr<int>;
+
+    std::size_t size = 0;
+    std::vector<std::unique_ptr<int>> elems;
+    bool from_iters = false;
+
+    ContainerWithSizedCtor() {}
+    template <typename T>
+    ContainerWithSizedCtor(T, T) : from_iters(true) {}
+
+    template <typename T>
+    void emplace_back(T &&) {from_iters = true;}
+};
+namespace better_init
+{
+    namespace custom
+    {
+        template <std::size_t N, typename Factory>
+        struct construct_sized<void, ContainerWithSizedCtor, N, Factory>
+        {
+            ContainerWithSizedCtor operator()(Factory factory) const
+            {
+                ContainerWithSizedCtor ret;
+                ret.size = N;
+                ret.elems.reserve(N);
+                for (std::size_t i = 0; i < N; i++)
+                    ret.elems.emplace_back(factory(i));
+                return ret;
+            }
+        };
+    }
+}
+
+// A vector with its own `custom::construct` specialization, which must not clash with how we construct vector-like containers by default.
+struct VectorWithCustomConstruct : std::vector<int>
+{
+    using std::vector<int>::vector;
+    VectorWithCustomConstruct() {}
+
+    bool custom = false;
+};
+namespace better_init
+{
+    namespace custom
+    {
+        template <typename Iter, typename ...P>
+        struct construct<void, VectorWithCustomConstruct, Iter, P...>
+        {
+            VectorWithCustomConstruct operator()(Iter begin, Iter end) const
+            {
+                VectorWithCustomConstruct ret;
+                ret.custom = true;
+                for (; begin != end; ++begin)
+                    ret.emplace_back(*begin);
+                return ret;
+            }
+        };
+    }
+}
+
+// A fake fixed-capacity concurrent queue, receives appended elements as one batch, see the `custom::append_sized` specialization below.
+// Counts the atomic operations used to claim the slots. Has no `.insert()` or `.end()`.
+struct BatchQueue
+{
+    using value_type = std::unique_ptr<int>;
+
+    std::unique_ptr<int> slots[8];
+    std::atomic<std::size_t> tail{0};
+    int claims = 0;
+};
+namespace better_init
+{
+    namespace custom
+    {
+        template <std::size_t N, typename Factory>
+        struct append_sized<void, BatchQueue, N, Factory>
+        {
+            std::size_t operator()(BatchQueue &queue, Factory factory) const
+            {
+                queue.claims++;
+                std::size_t first = queue.tail.fetch_add(N);
+                for (std::size_t i = 0; i < N; i++)
+                    queue.slots[first + i] = factory(i);
+                return first;
+            }
+        };
+    }
+}
+
+// A fake container, records whether it was constructed from pointers.
+struct ContainerRecordingIterators
+{
+    using value_type = int;
+
+    bool from_pointers = false;
+    std::size_t size = 0;
+
+    template <typename T>
+    ContainerRecordingIterators(T begin, T end) : from_pointers(std::is_pointer<T>::value), size(std::size_t(end - begin)) {}
+};
+
+// A trivially copyable type that can't be copied, only moved. Lists of it can't be packed.
+struct TrivialMoveOnly
+{
+    int value;
+
+    TrivialMoveOnly(int value) : value(value) {}
+    TrivialMoveOnly(const TrivialMoveOnly &) = delete;
+    TrivialMoveOnly(TrivialMoveOnly &&) = default;
+};
+
+// A vector with a constant template parameter, like `small_vector<T, N, Alloc>`. The allocator hack must still find its allocator.
+template <typename T, std::size_t N, typename A = std::allocator<T>>
+struct VectorWithConstant : std::vector<T, A>
+{
+    using std::vector<T, A>::vector;
+};
+
+// A vector that receives its allocator indirectly, see the `custom::rebind_allocator` specialization below.
+template <typename A>
+struct VectorOptions {using allocator_type = A;};
+template <typename T, typename Options>
+struct VectorWithOptions : std::vector<T, typename Options::allocator_type>
+{
+    using std::vector<T, typename Options::allocator_type>::vector;
+};
+namespace better_init
+{
+    namespace custom
+    {
+        template <typename T, typename Options>
+        struct rebind_allocator<VectorWithOptions<T, Options>>
+        {
+            using allocator_type = typename Options::allocator_type;
+            template <typename A>
+            using rebind = VectorWithOptions<T, VectorOptions<A>>;
+        };
+    }
+}
+
+#if HAVE_MEMORY_RESOURCE
+// A memory resource that counts the allocations.
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+
+    void *do_allocate(std::size_t n, std::size_t align) override
+    {
+        allocations++;
+        bytes += n;
+        return std::pmr::new_delete_resource()->allocate(n, align);
+    }
+    void do_deallocate(void *ptr, std::size_t n, std::size_t align) override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, n, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+#endif
+
+#if BETTER_INIT_PARALLEL
+// An executor for `better_init::parallel()`. Calls the function in reverse order, to make sure the order doesn't matter.
+struct ReverseExecutor
+{
+    std::size_t *calls;
+
+    template <typename F>
+    void operator()(std::size_t n, F func) const
+    {
+        *calls += n;
+        for (std::size_t i = n; i-- > 0;)
+            func(i);
+    }
+};
+
+// An executor for `better_init::parallel()` that calls the function on several threads, so that data races can be caught with `-fsanitize=thread`.
+template <typename F>
+struct ThreadExecutorFunc
+{
+    const F *func;
+    std::size_t first, n, step;
+
+    void operator()() const
+    {
+        for (std::size_t i = first; i < n; i += step)
+            (*func)(i);
+    }
+};
+struct ThreadExecutor
+{
+    std::size_t threads;
+
+    template <typename F>
+    void operator()(std::size_t n, F func) const
+    {
+        std::vector<std::thread> pool;
+        for (std::size_t i = 0; i < threads; i++)
+            pool.emplace_back(ThreadExecutorFunc<F>{&func, i, n, threads});
+        for (std::thread &thread : pool)
+            thread.join();
+    }
+};
+#endif
+
+// Counts the live instances. Throws on construction from a negative number.
+struct LiveCounted
+{
+    static std::atomic_int live; // Atomic, because the elements can be constructed concurrently.
+    int value;
+    LiveCounted(int value) : value(value)
+    {
+        #if __cpp_exceptions
+        if (value < 0)
+            throw value;
+        #endif
+        live++;
+    }
+    LiveCounted(LiveCounted &&other) noexcept : value(other.value) {live++;}
+    LiveCounted &operator=(LiveCounted &&) = delete;
+    ~LiveCounted() {live--;}
+};
+std::atomic_int LiveCounted::live{0};
+
+// Counts its moves. Has a large inline buffer, like the types `better_init::lazy()` is meant for.
+struct MoveCounted
+{
+    static int moves;
+    int value;
+    char buffer[256] = {};
+    MoveCounted(int value) : value(value) {}
+    MoveCounted(MoveCounted &&other) noexcept : value(other.value) {moves++;}
+    MoveCounted &operator=(MoveCounted &&) = delete;
+};
+int MoveCounted::moves = 0;
+
+// Records the types and values of the elements passed to it, for `.for_each()` and `.visit()`.
+struct ElemRecorder
+{
+    std::string *log;
+
+    void operator()(int &&value) const {*log += "int&&:" + std::to_string(value) + ";";}
+    void operator()(const int &value) const {*log += "const int&:" + std::to_string(value) + ";";}
+    void operator()(std::string &value) const {*log += "string&:" + value + ";"; value = "moved";}
+    template <std::size_t N>
+    void operator()(const char (&value)[N]) const {*log += "char array:" + std::string(value) + ";";}
+};
+
+// A non-movable type with a constructor that takes several arguments, for `better_init::args()`.
+struct Connection
+{
+    std::string host;
+    int port;
+    Connection(std::string host, int port) : host(std::move(host)), port(port) {}
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+};
+
+// Has a constructor template that accepts anything, and remembers whether it received an `int`.
+struct Greedy
+{
+    bool from_int = false;
+    template <typename T>
+    Greedy(T &&) : from_int(std::is_same<std::decay_t<T>, int>::value) {}
+};
+
+template <typename T>
+struct Make
+{
+    int value;
+    T operator()() const {return T(value);}
+};
+
+#if HAVE_HOOKS
+// How many times each `better_init::hook_event` was reported.
+// Atomic, because the elements can be constructed concurrently, see `better_init::parallel()`.
+std::atomic_int hook_counts[5] = {};
+void count_hook_event(better_init::hook_event event)
+{
+    hook_counts[int(event)]++;
+}
+int hook_count(better_init::hook_event event)
+{
+    return hook_counts[int(event)];
+}
+#endif
+
+// Constant evaluation.
+struct NonCopyableDescriptor
+{
+    int value;
+    constexpr NonCopyableDescriptor(int value) : value(value) {}
+    NonCopyableDescriptor(const NonCopyableDescriptor &) = delete;
+    NonCopyableDescriptor &operator=(const NonCopyableDescriptor &) = delete;
+};
+constexpr std::array<int, 3> constexpr_array = INIT(1, 2, 3);
+static_assert(constexpr_array[2] == 3, "");
+constexpr std::array<long, 2> constexpr_mixed_array = INIT(1, 2L);
+static_assert(constexpr_mixed_array[1] == 2, "");
+constexpr better_init::stored<int, long> constexpr_stored(1, 2L);
+constexpr std::array<long, 2> constexpr_stored_array = constexpr_stored;
+static_assert(constexpr_stored_array[1] == 2, "");
+#if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+constexpr std::array<NonCopyableDescriptor, 2> constexpr_descriptors = INIT(1, 2);
+static_assert(constexpr_descriptors[1].value == 2, "");
+#endif
+#if defined(__cpp_lib_constexpr_vector) && defined(__cpp_lib_constexpr_string)
+constexpr std::size_t constexpr_vectors()
+{
+    std::vector<int> vec1 = INIT(1, 2, 3);
+    std::vector<std::string> vec2 = INIT(std::string("ab"), "cde"); // Heterogeneous.
+    auto vec3 = INIT(4, 5).to<std::vector<long>>();
+    return std::size_t(vec1[0] + vec1[1] + vec1[2]) + vec2[0].size() + vec2[1].size() + std::size_t(vec3[1]);
+}
+static_assert(constexpr_vectors() == 6 + 5 + 5, "");
+#endif
+
+template <typename T> using AllocationSizeOf = decltype(better_init::custom::allocation_size<T, 3>::value);
+template <typename T> using MakeSorted = decltype(INIT(1, 2).to<T>(better_init::sorted));
 template <typename ...P> using MakeContainerWithForcedArgs = decltype(INIT(1, 2, 3).to<ContainerWithForcedArgs>(std::declval<P>()...));
 
 
 int main()
 {
-    // Iterator sanity tests.
-    (void)IteratorSanityChecker(INIT(1, 2, 3));
+    // Iterator sanity tests. Those lists aren't packed (see below), so they use our iterators.
+    int one = 1, two = 2, three = 3;
+    ASSERT(!IteratorSanityChecker(INIT(one, two, three)).from_pointers);
+    ASSERT(!IteratorSanityChecker(INIT(1, 2L, 3)).from_pointers);
 
     { // Generic usage tests.
         std::vector<std::unique_ptr<int>> vec1 = INIT(nullptr, std::make_unique<int>(42));
@@ -234,12 +645,585 @@ int main()
         ASSERT(vec5[0].load() == 4);
         ASSERT(vec5[1].load() == 5);
         ASSERT(vec5[2].load() == 6);
+
+        std::vector<std::unique_ptr<int>> vec6 = INIT(std::make_unique<int>(7));
+        ASSERT(vec6.size() == 1);
+        ASSERT(*vec6[0] == 7);
+    }
+
+    { // Homogeneous and mixed element types.
+        static_assert(better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int, int>::is_homogeneous, "");
+        static_assert(!better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int &, int>::is_homogeneous, "");
+
+        std::vector<std::unique_ptr<int>> vec1 = INIT(std::make_unique<int>(1), std::make_unique<int>(2), std::make_unique<int>(3));
+        ASSERT(vec1.size() == 3);
+        ASSERT(*vec1[0] == 1 && *vec1[1] == 2 && *vec1[2] == 3);
+
+        // Same decayed type, but different value categories. The lvalue must be copied, not moved.
+        std::string str = "foo";
+        std::vector<std::string> vec2 = INIT(str, std::string("bar"), str);
+        ASSERT(vec2.size() == 3);
+        ASSERT(vec2[0] == "foo" && vec2[1] == "bar" && vec2[2] == "foo");
+        ASSERT(str == "foo");
+
+        // Interleaved element types. The elements are grouped by type internally, but must keep their order.
+        short s = 2;
+        long l = 4;
+        std::vector<long> vec3 = INIT(1, s, 3, l, 5, s, short(7));
+        ASSERT((vec3 == std::vector<long>{1, 2, 3, 4, 5, 2, 7}));
+        std::array<long, 7> arr3 = INIT(1, s, 3, l, 5, s, short(7));
+        ASSERT((arr3 == std::array<long, 7>{{1, 2, 3, 4, 5, 2, 7}}));
+        // The grouping is the same with any compiler flags, including `-fsanitize=undefined`, where we can't compare types by address.
+        using layout = better_init::detail::layout_of<int, short &, int, long &, int, short &, short>;
+        static_assert(layout::value.num_kinds == 4, "");
+        static_assert(layout::value.kinds[4] == 0 && layout::value.slots[4] == 2, "");
+        static_assert(layout::value.kinds[5] == 1 && layout::value.slots[5] == 1 && layout::value.kinds[6] == 3, "");
+
+        // A copy of a list must refer to the same elements, not into the original list.
+        auto list = INIT(s, l, s);
+        auto list_copy = list;
+        std::vector<long> vec4 = std::move(list_copy);
+        ASSERT((vec4 == std::vector<long>{2, 4, 2}));
+    }
+
+    { // Lazy elements.
+        MoveCounted::moves = 0;
+        std::vector<MoveCounted> vec = INIT(better_init::lazy(Make<MoveCounted>{1}), MoveCounted(2), better_init::lazy(Make<MoveCounted>{3}));
+        ASSERT(vec.size() == 3 && vec[0].value == 1 && vec[1].value == 2 && vec[2].value == 3);
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        ASSERT_EQ(MoveCounted::moves, 1); // Only the non-lazy element.
+        #endif
+
+        // Converting the result.
+        std::vector<long> vec2 = INIT(better_init::lazy(Make<int>{4}), 5);
+        ASSERT(vec2.size() == 2 && vec2[0] == 4 && vec2[1] == 5);
+
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        // Non-movable results.
+        std::array<NonCopyableDescriptor, 2> arr = INIT(better_init::lazy(Make<NonCopyableDescriptor>{6}), 7);
+        ASSERT(arr[0].value == 6 && arr[1].value == 7);
+        #endif
+
+        // Appending to an existing container.
+        better_init::append(vec2, INIT(better_init::lazy(Make<int>{8}), 9));
+        ASSERT(vec2.size() == 4 && vec2[2] == 8 && vec2[3] == 9);
+
+        // Through `.emplace_back()`, the results are constructed once too, and the constructors receive them rather than the lazy elements.
+        MoveCounted::moves = 0;
+        std::vector<MoveCounted> vec3 = better_init::concat(INIT(better_init::lazy(Make<MoveCounted>{10})));
+        ASSERT(vec3.size() == 1 && vec3[0].value == 10);
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        ASSERT_EQ(MoveCounted::moves, 0);
+        #endif
+        std::vector<Greedy> greedy = better_init::concat(INIT(better_init::lazy(Make<int>{11})));
+        ASSERT(greedy.size() == 1 && greedy[0].from_int);
+    }
+
+    { // Construction with `.reserve()` and `.emplace_back()`.
+        int a = 1;
+        ContainerWithEmplaceBack cont = INIT(a, 2, a).to<ContainerWithEmplaceBack>();
+        ASSERT(!cont.from_iters);
+        ASSERT_EQ(cont.reserved, 3);
+        ASSERT_EQ(cont.emplaced, "lrl");
+
+        std::deque<std::unique_ptr<int>> deq = INIT(nullptr, std::make_unique<int>(42));
+        ASSERT(deq.size() == 2);
+        ASSERT(deq[0] == nullptr);
+        ASSERT(deq[1] != nullptr && *deq[1] == 42);
+
+        std::vector<std::unique_ptr<int>> vec = INIT(nullptr, std::make_unique<int>(42));
+        ASSERT(vec.capacity() == 2);
+    }
+
+    { // Fixed-size aggregates.
+        std::array<std::unique_ptr<int>, 2> arr1 = INIT(nullptr, std::make_unique<int>(42));
+        ASSERT(arr1[0] == nullptr);
+        ASSERT(arr1[1] != nullptr && *arr1[1] == 42);
+
+        auto arr2 = INIT(1, 2, 3).to<std::array<int, 3>>();
+        ASSERT(arr2[0] == 1 && arr2[1] == 2 && arr2[2] == 3);
+
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        std::array<std::atomic_int, 3> arr3 = INIT(1, 2, 3);
+        ASSERT(arr3[0].load() == 1 && arr3[1].load() == 2 && arr3[2].load() == 3);
+
+        std::array<std::atomic_int, 0> arr4 = INIT();
+        (void)arr4;
+        #endif
+
+        // The size must match.
+        static_assert(better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>::can_initialize_array<std::array<int, 2>>, "");
+        static_assert(!better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>::can_initialize_array<std::array<int, 1>>, "");
+        static_assert(!better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>::can_initialize_array<std::array<int, 3>>, "");
+        static_assert(!std::is_constructible<std::array<int, 3>, better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>>::value, "");
+
+        // Not an aggregate.
+        static_assert(!better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>::can_initialize_array<std::vector<int>>, "");
+    }
+
+    { // Sized construction.
+        ContainerWithSizedCtor cont1 = INIT(std::make_unique<int>(1), nullptr).to<ContainerWithSizedCtor>();
+        ASSERT(!cont1.from_iters && cont1.size == 2 && cont1.elems.size() == 2);
+        ASSERT(*cont1.elems[0] == 1 && cont1.elems[1] == nullptr);
+
+        ContainerWithSizedCtor cont2 = INIT().to<ContainerWithSizedCtor>();
+        ASSERT(!cont2.from_iters && cont2.size == 0);
+    }
+
+    { // Custom construction, for a type that we'd otherwise construct with `.emplace_back()`.
+        VectorWithCustomConstruct vec1 = INIT(1, 2, 3).to<VectorWithCustomConstruct>();
+        ASSERT(vec1.custom && vec1 == std::vector<int>({1, 2, 3}));
+
+        int x = 2;
+        VectorWithCustomConstruct vec2 = INIT(1, x, 3L).to<VectorWithCustomConstruct>();
+        ASSERT(vec2.custom && vec2 == std::vector<int>({1, 2, 3}));
+    }
+
+    { // Construction from sorted elements.
+        std::map<int, std::atomic_int> map = INIT(std::make_pair(1, 10), std::make_pair(2, 20), std::make_pair(3L, 30)).to<std::map<int, std::atomic_int>>(better_init::sorted);
+        ASSERT(map.size() == 3 && map.at(1).load() == 10 && map.at(3).load() == 30);
+
+        std::multiset<std::string, std::greater<std::string>> set = INIT("c", std::string("b"), "b").to<std::multiset<std::string, std::greater<std::string>>>(better_init::sorted);
+        ASSERT(set.size() == 3 && *set.begin() == "c");
+
+        std::set<int> empty = INIT().to<std::set<int>>(better_init::sorted);
+        ASSERT(empty.empty());
+
+        static_assert(is_detected<MakeSorted, std::set<int>>::value, "");
+        static_assert(!is_detected<MakeSorted, std::vector<int>>::value, "");
+    }
+
+    { // Construction of unordered containers.
+        UnorderedContainerWithEmplace cont = INIT(1, 2, 3).to<UnorderedContainerWithEmplace>();
+        ASSERT(!cont.from_iters);
+        ASSERT_EQ(cont.reserved, 3);
+        ASSERT_EQ(cont.emplaced, 3);
+
+        std::unordered_map<std::string, std::unique_ptr<int>> map1 = INIT(std::make_pair("a", std::make_unique<int>(1)), std::make_pair("b", nullptr));
+        ASSERT(map1.size() == 2);
+        ASSERT(*map1.at("a") == 1);
+        ASSERT(map1.at("b") == nullptr);
+
+        std::unordered_map<int, std::atomic_int> map2 = INIT(std::make_pair(1, 10), std::make_pair(2, 20));
+        ASSERT(map2.size() == 2);
+        ASSERT(map2.at(1).load() == 10 && map2.at(2).load() == 20);
+    }
+
+    { // Replacing the allocators of unusual containers.
+        using vector_with_constant = VectorWithConstant<std::atomic_int, 4>;
+        using vector_with_options = VectorWithOptions<std::atomic_int, VectorOptions<std::allocator<std::atomic_int>>>;
+        #if BETTER_INIT_ALLOCATOR_HACK
+        static_assert(better_init::detail::allocator_hack::has_replaceable_allocator<vector_with_constant>::value, "");
+        static_assert(better_init::detail::allocator_hack::has_replaceable_allocator<vector_with_options>::value, "");
+        static_assert(std::is_same<typename better_init::detail::allocator_hack::substitute_allocator<vector_with_options>::type,
+            VectorWithOptions<std::atomic_int, VectorOptions<better_init::detail::allocator_hack::modified_allocator<std::allocator<std::atomic_int>>>>>::value, "");
+        #endif
+
+        // Non-movable elements need the allocator hack before C++17.
+        vector_with_constant vec1 = INIT(1, 2, 3);
+        ASSERT(vec1.size() == 3 && vec1[2].load() == 3);
+        vector_with_options vec2 = INIT(4, 5L);
+        ASSERT(vec2.size() == 2 && vec2[0].load() == 4 && vec2[1].load() == 5);
+    }
+
+    { // Inserting into existing containers.
+        std::vector<std::unique_ptr<int>> vec;
+        vec.push_back(std::make_unique<int>(1));
+        better_init::append(vec, INIT(std::make_unique<int>(4), std::make_unique<int>(5)));
+        auto it = better_init::insert(vec, vec.begin() + 1, INIT(std::make_unique<int>(2), nullptr));
+        ASSERT(it == vec.begin() + 1);
+        better_init::append(vec, INIT());
+
+        // Batch appending, see `custom::append_sized`.
+        BatchQueue queue;
+        ASSERT_EQ(better_init::append(queue, INIT(std::make_unique<int>(1), nullptr)), 0u);
+        ASSERT_EQ(better_init::append(queue, INIT(std::make_unique<int>(3), std::make_unique<int>(4), nullptr)), 2u);
+        ASSERT_EQ(queue.claims, 2);
+        ASSERT_EQ(queue.tail.load(), 5u);
+        ASSERT(*queue.slots[0] == 1 && !queue.slots[1] && *queue.slots[3] == 4 && !queue.slots[4]);
+        ASSERT(vec.size() == 5);
+        ASSERT(*vec[0] == 1 && *vec[1] == 2 && vec[2] == nullptr && *vec[3] == 4 && *vec[4] == 5);
+
+        std::string str = "foo";
+        std::vector<std::string> strings = {"bar"};
+        better_init::insert(strings, strings.begin(), INIT(str, std::string("baz")));
+        ASSERT(strings.size() == 3);
+        ASSERT(strings[0] == "foo" && strings[1] == "baz" && strings[2] == "bar");
+        ASSERT(str == "foo");
+    }
+
+    { // Elements from several arguments.
+        MoveCounted::moves = 0;
+        std::vector<MoveCounted> vec = INIT(better_init::args(1), better_init::args(2));
+        ASSERT(vec.size() == 2 && vec[1].value == 2);
+        ASSERT_EQ(MoveCounted::moves, 0);
+
+        std::vector<std::string> strings = INIT(better_init::args(3, 'x'), "y");
+        ASSERT(strings.size() == 2 && strings[0] == "xxx" && strings[1] == "y");
+        std::unordered_map<std::string, int> map = INIT(better_init::args("a", 1), std::make_pair("b", 2));
+        ASSERT(map.size() == 2 && map.at("a") == 1);
+
+        // Non-movable types are constructed in place.
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION || BETTER_INIT_ALLOCATOR_HACK
+        std::string host = "localhost";
+        std::vector<Connection> connections = INIT(better_init::args(host, 80), better_init::args("example.com", 443));
+        ASSERT(connections.size() == 2 && connections[0].host == "localhost" && connections[1].port == 443);
+        #endif
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        std::array<Connection, 2> arr = INIT(better_init::args("a", 1), better_init::args("b", 2));
+        ASSERT(arr[1].host == "b" && arr[1].port == 2);
+        auto inline_connections = INIT(better_init::args("a", 1)).to_inline<Connection>();
+        ASSERT(inline_connections[0].port == 1);
+        #endif
+
+        alignas(Connection) unsigned char buffer[sizeof(Connection) * 2];
+        Connection *dest = reinterpret_cast<Connection *>(buffer);
+        Connection *end = better_init::uninitialized_construct(INIT(better_init::args("a", 1), better_init::args("b", 2)), dest);
+        ASSERT(end == dest + 2 && dest[1].host == "b");
+        dest[0].~Connection();
+        dest[1].~Connection();
+    }
+
+    { // Iterating over the elements with their original types.
+        std::string log;
+        std::string str = "s";
+        const int x = 2;
+        INIT(1, x, str, "abc").for_each(ElemRecorder{&log});
+        ASSERT_EQ(log, "int&&:1;const int&:2;string&:s;char array:abc;");
+        ASSERT_EQ(str, "moved");
+        INIT().for_each(ElemRecorder{&log});
+
+        log.clear();
+        INIT(1, x, str).visit<1>(ElemRecorder{&log});
+        ASSERT_EQ(log, "const int&:2;");
+
+        // The value categories are preserved, so move-only elements can be consumed.
+        auto ptr = std::make_unique<int>(5);
+        std::unique_ptr<int> target;
+        INIT(std::move(ptr)).visit<0>([&](std::unique_ptr<int> &&p){target = std::move(p);});
+        ASSERT(!ptr && *target == 5);
+    }
+
+    { // Concatenation.
+        std::vector<std::unique_ptr<int>> plugins;
+        plugins.push_back(std::make_unique<int>(3));
+        plugins.push_back(std::make_unique<int>(4));
+        auto handlers = better_init::concat(INIT(std::make_unique<int>(1), std::make_unique<int>(2)), std::move(plugins), INIT(nullptr)).to<std::vector<std::unique_ptr<int>>>();
+        ASSERT(handlers.size() == 5 && handlers.capacity() == 5);
+        ASSERT(*handlers[0] == 1 && *handlers[2] == 3 && *handlers[3] == 4 && !handlers[4]);
+        ASSERT(plugins.size() == 2 && !plugins[0]);
+
+        // Lvalue ranges are copied. Arrays work too.
+        std::vector<std::string> strings = {"b", "c"};
+        const char *array[] = {"d"};
+        ASSERT_EQ(better_init::concat(INIT("a"), strings, array).size(), 4u);
+        std::vector<std::string> all = better_init::concat(INIT("a"), strings, array);
+        ASSERT(all.size() == 4 && all[0] == "a" && all[1] == "b" && all[3] == "d");
+        ASSERT(strings.size() == 2 && strings[1] == "c");
+        std::deque<std::string> deque = better_init::concat(strings, INIT());
+        ASSERT(deque.size() == 2 && deque[0] == "b");
+
+        // The list elements are constructed in place.
+        MoveCounted::moves = 0;
+        std::vector<MoveCounted> moved = better_init::concat(INIT(better_init::args(1), 2), INIT(3));
+        ASSERT(moved.size() == 3 && moved[2].value == 3);
+        ASSERT_EQ(MoveCounted::moves, 0);
+
+        static_assert(!decltype(better_init::concat(INIT(1)))::can_initialize<std::set<int>>, "No `.emplace_back()`.");
+        static_assert(!decltype(better_init::concat(INIT(1), std::vector<std::string>{}))::can_initialize<std::vector<int>>, "The range elements don't convert.");
+        static_assert(!decltype(better_init::concat(std::vector<int>{}, INIT("a")))::can_initialize<std::vector<int>>, "The list elements don't convert.");
+        static_assert(!std::is_convertible<decltype(better_init::concat(INIT(1), std::vector<std::string>{})), std::vector<int>>::value, "");
+        static_assert(!decltype(better_init::concat(plugins))::can_initialize<std::vector<std::unique_ptr<int>>>, "Lvalue ranges are copied.");
+        static_assert(decltype(better_init::concat(std::move(plugins)))::can_initialize<std::vector<std::unique_ptr<int>>>, "");
+
+        // Lvalue lists. The elements must outlive the list, so they aren't temporaries here.
+        int one = 1, two = 2;
+        auto list = INIT(one, two);
+        std::vector<int> ints = better_init::concat(list, std::vector<int>{3}, list);
+        ASSERT(ints.size() == 5 && ints[1] == 2 && ints[2] == 3 && ints[4] == 2);
+    }
+
+    { // Moving from lvalues.
+        auto a = std::make_unique<int>(1), b = std::make_unique<int>(2);
+        std::vector<std::unique_ptr<int>> ptrs = INIT(a, std::make_unique<int>(3), b).moved();
+        ASSERT(ptrs.size() == 3 && *ptrs[0] == 1 && *ptrs[2] == 2);
+        ASSERT(!a && !b);
+
+        // Const lvalues are still copied.
+        const std::string str(32, 'x');
+        std::string str2(32, 'y');
+        std::vector<std::string> strings = INIT(str, str2, "z").moved();
+        ASSERT(strings.size() == 3 && strings[0] == str && strings[1] == std::string(32, 'y') && strings[2] == "z");
+        ASSERT(str.size() == 32);
+
+        static_assert(std::is_same<decltype(INIT(str2, str, 1, std::move(str2)).moved()), better_init::DETAIL_BETTER_INIT_CLASS_NAME<std::string &&, const std::string &, int, std::string>>::value, "");
+
+        MoveCounted::moves = 0;
+        MoveCounted m1(1), m2(2);
+        std::vector<MoveCounted> moved = INIT(m1, m2).moved();
+        ASSERT(moved.size() == 2 && moved[1].value == 2);
+        ASSERT(MoveCounted::moves == 2);
+    }
+
+    { // Inline vectors.
+        auto vec = INIT(1, 2L, 3).to_inline<int>();
+        static_assert(std::is_same<decltype(vec), better_init::inline_vector<int, 3>>::value, "");
+        static_assert(decltype(vec)::capacity() == 3, "");
+        ASSERT(vec.size() == 3 && vec[0] == 1 && vec[2] == 3);
+        int sum = 0;
+        for (int x : vec)
+            sum += x;
+        ASSERT_EQ(sum, 6);
+
+        better_init::inline_vector<std::unique_ptr<int>, 4> ptrs = INIT(std::make_unique<int>(1), nullptr);
+        ASSERT(ptrs.size() == 2 && *ptrs[0] == 1 && !ptrs[1]);
+        ptrs.emplace_back(std::make_unique<int>(3));
+        ptrs.pop_back();
+        ASSERT(ptrs.size() == 2);
+
+        auto empty = INIT().to_inline<std::string>();
+        ASSERT(empty.empty() && empty.begin() == empty.end());
+
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        // Non-movable elements are constructed in place.
+        auto atomics = INIT(1, 2, 3).to_inline<std::atomic_int>();
+        ASSERT(atomics.size() == 3 && atomics[2].load() == 3);
+        #endif
+        static_assert(!std::is_move_constructible<better_init::inline_vector<std::atomic_int, 3>>::value, "");
+        static_assert(std::is_move_constructible<better_init::inline_vector<std::unique_ptr<int>, 3>>::value, "");
+        static_assert(!std::is_copy_constructible<better_init::inline_vector<int, 3>>::value, "");
+
+        // Elements are destroyed, including when one of the constructors throws.
+        #if __cpp_exceptions
+        LiveCounted::live = 0;
+        bool thrown = false;
+        try
+        {
+            (void)INIT(1, 2, -1).to_inline<LiveCounted>();
+        }
+        catch (...)
+        {
+            thrown = true;
+        }
+        ASSERT(thrown && LiveCounted::live == 0);
+        #endif
+    }
+
+    { // Ranges.
+        static_assert(better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, long>::size() == 2, "");
+        static_assert(decltype(INIT(1, 2L, 3).range<int>())::size() == 3, "");
+
+        int a = 1;
+        long b = 2;
+        int sum = 0;
+        for (int x : INIT(a, b, a).range<int>())
+            sum += x;
+        ASSERT_EQ(sum, 4);
+
+        // Copies have their own iterators.
+        auto range = INIT(a, b).range<long>();
+        auto copy = range;
+        ASSERT(copy.begin() != range.begin() || BETTER_INIT_PROXY_ITERATORS);
+        std::vector<long> vec(copy.begin(), copy.end());
+        ASSERT(vec.size() == 2 && vec[0] == 1 && vec[1] == 2);
+
+        auto empty = INIT().range<int>();
+        ASSERT(empty.begin() == empty.end() && empty.empty());
+
+        #ifdef __cpp_lib_ranges
+        static_assert(std::ranges::sized_range<decltype(range)>, "");
+        static_assert(std::ranges::random_access_range<decltype(range)>, "");
+
+        int out[3] = {};
+        std::ranges::uninitialized_copy(INIT(4, 5L, 6).range<int>(), out);
+        ASSERT(out[0] == 4 && out[1] == 5 && out[2] == 6);
+        #endif
+
+        #ifdef __cpp_lib_containers_ranges
+        std::vector<std::unique_ptr<int>> vec2(std::from_range, INIT(nullptr, std::make_unique<int>(7)).range<std::unique_ptr<int>>());
+        ASSERT(vec2.size() == 2 && vec2[0] == nullptr && *vec2[1] == 7);
+        #endif
+        #ifdef __cpp_lib_ranges_to_container
+        auto vec3 = std::ranges::to<std::vector<long>>(INIT(8, 9L).range<long>());
+        ASSERT(vec3.size() == 2 && vec3[1] == 9);
+        #endif
+    }
+
+    { // Owning lists.
+        auto strings = better_init::make_stored(std::string("a"), "b");
+        static_assert(std::is_same<decltype(strings), better_init::stored<std::string, const char *>>::value, "");
+        for (int i = 0; i < 2; i++)
+        {
+            std::vector<std::string> vec = strings;
+            ASSERT(vec.size() == 2 && vec[0] == "a" && vec[1] == "b");
+        }
+
+        // Non-movable elements.
+        std::vector<std::atomic_int> atomics = better_init::make_stored(1, 2L);
+        ASSERT(atomics.size() == 2 && atomics[1].load() == 2);
+
+        // Homogeneous trivially copyable elements are copied from an array.
+        const auto ints = better_init::make_stored(1, 2, 3);
+        auto cont = ints.to<ContainerRecordingIterators>();
+        ASSERT(cont.from_pointers && cont.size == 3);
+        std::vector<int> vec = ints;
+        ASSERT(vec.size() == 3 && vec[2] == 3);
+        std::vector<long> vec2 = ints; // Different element type, not from pointers.
+        ASSERT(vec2.size() == 3 && vec2[2] == 3);
+        std::array<int, 3> arr = ints;
+        ASSERT(arr[0] == 1 && arr[2] == 3);
+
+        // Everything else goes through `.list()`.
+        better_init::append(vec, ints.list());
+        ASSERT(vec.size() == 6 && vec[5] == 3);
+
+        better_init::stored<> empty;
+        std::vector<int> vec3 = empty;
+        ASSERT(vec3.empty());
+
+        // Narrowing conversions are allowed, both for mixed and for homogeneous types.
+        long n = 2;
+        better_init::stored<int, long> mixed(n, 3);
+        std::vector<long> vec4 = mixed;
+        ASSERT(vec4.size() == 2 && vec4[0] == 2 && vec4[1] == 3);
+        better_init::stored<int, int> same(n, 3L);
+        std::vector<int> vec5 = same;
+        ASSERT(vec5.size() == 2 && vec5[0] == 2 && vec5[1] == 3);
+    }
+
+    { // Packed lists.
+        // Prvalues of the same trivially copyable type are copied into the list, and the container receives pointers to them.
+        auto cont = INIT(1, 2, 3).to<ContainerRecordingIterators>();
+        ASSERT_EQ(cont.from_pointers, bool(BETTER_INIT_PACK_TRIVIAL_ELEMENTS));
+        ASSERT_EQ(cont.size, 3u);
+        ASSERT_EQ(IteratorSanityChecker(INIT(1, 2, 3)).from_pointers, bool(BETTER_INIT_PACK_TRIVIAL_ELEMENTS));
+        std::vector<int> vec = INIT(4, 5, 6);
+        ASSERT(vec.size() == 3 && vec[0] == 4 && vec[2] == 6);
+        std::vector<long> vec2 = INIT(4, 5, 6); // Different element type, not from pointers.
+        ASSERT(vec2.size() == 3 && vec2[2] == 6);
+        std::array<int, 3> arr = INIT(7, 8, 9);
+        ASSERT(arr[0] == 7 && arr[2] == 9);
+
+        // Not packed: lvalues, different types, or non-trivially-copyable types.
+        int x = 1;
+        ASSERT(!INIT(x, 2, 3).to<ContainerRecordingIterators>().from_pointers);
+        ASSERT(!INIT(1, 2L, 3).to<ContainerRecordingIterators>().from_pointers);
+        std::vector<std::string> strings = INIT(std::string("a"), std::string("b"));
+        ASSERT(strings.size() == 2 && strings[1] == "b");
+
+        // Not packed: trivially copyable, but not copy-constructible.
+        static_assert(std::is_trivially_copyable<TrivialMoveOnly>::value, "");
+        static_assert(!decltype(INIT(TrivialMoveOnly(1), TrivialMoveOnly(2)))::is_packed, "");
+        std::vector<TrivialMoveOnly> move_only = INIT(TrivialMoveOnly(1), TrivialMoveOnly(2));
+        ASSERT(move_only.size() == 2 && move_only[0].value == 1 && move_only[1].value == 2);
+    }
+
+    { // Construction in uninitialized memory.
+        alignas(std::atomic_int) unsigned char buffer[sizeof(std::atomic_int) * 3];
+        std::atomic_int *dest = reinterpret_cast<std::atomic_int *>(buffer);
+        static_assert(noexcept(better_init::uninitialized_construct(INIT(1, 2L, 3), dest)), "");
+        std::atomic_int *end = better_init::uninitialized_construct(INIT(1, 2L, 3), dest);
+        ASSERT(end == dest + 3 && dest[0].load() == 1 && dest[1].load() == 2 && dest[2].load() == 3);
+        for (std::atomic_int *it = dest; it != end; it++)
+            it->~atomic();
+
+        // Empty lists.
+        ASSERT(better_init::uninitialized_construct(INIT(), dest) == dest);
+
+        // Lazy elements.
+        alignas(MoveCounted) unsigned char buffer2[sizeof(MoveCounted)];
+        MoveCounted::moves = 0;
+        MoveCounted *dest2 = reinterpret_cast<MoveCounted *>(buffer2);
+        better_init::uninitialized_construct(INIT(better_init::lazy(Make<MoveCounted>{4})), dest2);
+        ASSERT(dest2->value == 4);
+        #if BETTER_INIT_HAVE_MANDATORY_COPY_ELISION
+        ASSERT_EQ(MoveCounted::moves, 0);
+        #endif
+        dest2->~MoveCounted();
+
+        #if __cpp_exceptions
+        // If an element throws, the ones before it are destroyed.
+        alignas(LiveCounted) unsigned char buffer3[sizeof(LiveCounted) * 3];
+        bool thrown = false;
+        try
+        {
+            better_init::uninitialized_construct(INIT(1, 2, -3), reinterpret_cast<LiveCounted *>(buffer3));
+        }
+        catch (int e)
+        {
+            thrown = e == -3;
+        }
+        ASSERT(thrown);
+        ASSERT_EQ(LiveCounted::live, 0);
+        #endif
+    }
+
+    { // Nested lists.
+        std::vector<std::vector<std::unique_ptr<int>>> vec1 = INIT(INIT(std::make_unique<int>(1), nullptr), INIT(), INIT(std::make_unique<int>(2)));
+        ASSERT(vec1.size() == 3);
+        ASSERT(vec1[0].size() == 2 && *vec1[0][0] == 1 && vec1[0][1] == nullptr);
+        ASSERT(vec1[1].empty());
+        ASSERT(vec1[2].size() == 1 && *vec1[2][0] == 2);
+
+        std::vector<std::vector<std::atomic_int>> vec2 = INIT(INIT(1, 2), INIT(3));
+        ASSERT(vec2.size() == 2 && vec2[0].size() == 2 && vec2[1].size() == 1);
+        ASSERT(vec2[0][0].load() == 1 && vec2[0][1].load() == 2 && vec2[1][0].load() == 3);
+
+        // The inner containers are constructed in place.
+        move_counting_vector_moves = 0;
+        std::vector<MoveCountingVector<std::atomic_int>> vec3 = INIT(INIT(1, 2), INIT(3, 4, 5));
+        ASSERT(vec3.size() == 2 && vec3[0].size() == 2 && vec3[1].size() == 3);
+        ASSERT(vec3[1][2].load() == 5);
+        ASSERT(move_counting_vector_moves == 0);
+
+        std::array<std::vector<std::unique_ptr<int>>, 2> arr = INIT(INIT(nullptr), INIT(std::make_unique<int>(3), nullptr));
+        ASSERT(arr[0].size() == 1 && arr[1].size() == 2 && *arr[1][0] == 3);
+    }
+
+    { // Allocation size and memory resources.
+        static_assert(better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int, int>::allocation_size<std::vector<int>> == 3 * sizeof(int), "");
+        static_assert(better_init::DETAIL_BETTER_INIT_CLASS_NAME<>::allocation_size<std::vector<std::string>> == 0, "");
+        static_assert(is_detected<AllocationSizeOf, std::vector<int>>::value, "");
+        static_assert(!is_detected<AllocationSizeOf, std::deque<int>>::value, ""); // Unknown in advance.
+
+        #if HAVE_MEMORY_RESOURCE
+        using vector_type = std::pmr::vector<std::unique_ptr<int>>;
+        CountingResource res;
+        vector_type vec = INIT(std::make_unique<int>(1), nullptr, std::make_unique<int>(3)).to_pmr<vector_type>(&res);
+        ASSERT(vec.size() == 3 && *vec[0] == 1 && vec[1] == nullptr && *vec[2] == 3);
+        ASSERT(vec.get_allocator().resource() == &res);
+        ASSERT_EQ(res.allocations, 1);
+        ASSERT_EQ(res.bytes, (better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int, int>::allocation_size<vector_type>));
+
+        // Non-movable elements.
+        std::pmr::vector<std::atomic_int> vec2 = INIT(1, 2).to_pmr<std::pmr::vector<std::atomic_int>>(&res);
+        ASSERT(vec2.size() == 2 && vec2[1].load() == 2);
+        ASSERT_EQ(res.allocations, 2);
+
+        // Allocator-aware elements allocate from the same resource, which isn't included in `allocation_size`.
+        using string_vector_type = std::pmr::vector<std::pmr::string>;
+        const char *long_string = "a string that's too long for the small string optimization";
+        CountingResource res2;
+        string_vector_type vec3 = INIT(long_string, "b", long_string).to_pmr<string_vector_type>(&res2);
+        ASSERT(vec3.size() == 3 && vec3[0] == long_string && vec3[1] == "b" && vec3[2] == long_string);
+        ASSERT(vec3[0].get_allocator().resource() == &res2);
+        ASSERT_EQ(res2.allocations, 3); // The vector, and the two long strings.
+        ASSERT(res2.bytes > (better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int, int>::allocation_size<string_vector_type>));
+        #endif
     }
 
     { // Implicit-ness of the conversion operator.
         static_assert(!std::is_convertible<better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>, ContainerWithoutListCtor>::value, "");
         static_assert(std::is_constructible<ContainerWithoutListCtor, better_init::DETAIL_BETTER_INIT_CLASS_NAME<int, int>>::value, "");
         (void)INIT(1, 2).to<ContainerWithoutListCtor>();
+
+        // Direct-initialization must not be ambiguous.
+        std::vector<int> vec(INIT(1, 2));
+        ASSERT(vec.size() == 2);
+        std::array<int, 2> arr(INIT(1, 2));
+        ASSERT(arr[1] == 2);
+        ContainerWithoutListCtor cont(INIT(1, 2));
+        (void)cont;
     }
 
     { // Construction with extra arguments.
@@ -250,6 +1234,100 @@ int main()
         (void)INIT(1, 2, 3).to<ContainerWithForcedArgs>(1, 2, 3);
     }
 
+    #if BETTER_INIT_PARALLEL
+    { // Parallel construction.
+        std::size_t calls = 0;
+        std::vector<std::string> vec = INIT("a", std::string("b"), "c").to<std::vector<std::string>>(better_init::parallel(ReverseExecutor{&calls}));
+        ASSERT(vec.size() == 3 && vec[0] == "a" && vec[1] == "b" && vec[2] == "c");
+        ASSERT_EQ(calls, 3);
+
+        std::deque<int> deq = INIT(1, 2L).to<std::deque<int>>(better_init::parallel(ReverseExecutor{&calls}));
+        ASSERT(deq.size() == 2 && deq[0] == 1 && deq[1] == 2);
+        ASSERT_EQ(calls, 5);
+
+        // Empty lists don't call the executor.
+        std::vector<int> empty = INIT().to<std::vector<int>>(better_init::parallel(ReverseExecutor{&calls}));
+        ASSERT(empty.empty());
+        ASSERT_EQ(calls, 5);
+
+        #if BETTER_INIT_ALLOCATOR_HACK
+        // Non-movable elements are constructed in place.
+        std::vector<std::atomic_int> atomics = INIT(1, 2, 3).to<std::vector<std::atomic_int>>(better_init::parallel(ReverseExecutor{&calls}));
+        ASSERT(atomics.size() == 3 && atomics[0].load() == 1 && atomics[2].load() == 3);
+        ASSERT_EQ(calls, 8);
+        #endif
+
+        #if __cpp_exceptions
+        // If an element throws, the others are destroyed.
+        bool thrown = false;
+        try
+        {
+            (void)INIT(1, -2, 3).to<std::vector<LiveCounted>>(better_init::parallel(ReverseExecutor{&calls}));
+        }
+        catch (int e)
+        {
+            thrown = e == -2;
+        }
+        ASSERT(thrown);
+        ASSERT_EQ(LiveCounted::live, 0);
+        #endif
+
+        // On real threads.
+        std::vector<std::string> strings = INIT(
+            std::string(32, 'a'), "b", std::string(32, 'c'), "d", std::string(32, 'e'), "f", std::string(32, 'g'), "h",
+            "i", std::string(32, 'j'), "k", std::string(32, 'l'), "m", std::string(32, 'n'), "o", std::string(32, 'p')
+        ).to<std::vector<std::string>>(better_init::parallel(ThreadExecutor{4}));
+        ASSERT(strings.size() == 16 && strings[0] == std::string(32, 'a') && strings[1] == "b" && strings[15] == std::string(32, 'p'));
+
+        #if BETTER_INIT_ALLOCATOR_HACK
+        std::vector<std::atomic_int> atomics2 = INIT(1, 2, 3, 4, 5, 6, 7, 8).to<std::vector<std::atomic_int>>(better_init::parallel(ThreadExecutor{3}));
+        ASSERT(atomics2.size() == 8 && atomics2[0].load() == 1 && atomics2[7].load() == 8);
+        #endif
+
+        #if __cpp_exceptions
+        // Several elements throw concurrently, the first exception is rethrown and the rest are destroyed.
+        thrown = false;
+        try
+        {
+            (void)INIT(1, 2, -3, 4, 5, -6, 7, 8).to<std::vector<LiveCounted>>(better_init::parallel(ThreadExecutor{4}));
+        }
+        catch (int e)
+        {
+            thrown = e == -3;
+        }
+        ASSERT(thrown);
+        ASSERT_EQ(LiveCounted::live, 0);
+        #endif
+    }
+    #endif
+
+    #if HAVE_HOOKS
+    { // Instrumentation hooks.
+        using better_init::hook_event;
+
+        // Not movable, so not constructed with `.emplace_back()`.
+        for (std::atomic_int &count : hook_counts)
+            count = 0;
+        std::vector<std::atomic_int> vec = INIT(1, 2L, 3);
+        ASSERT(vec.size() == 3);
+        ASSERT_EQ(hook_count(hook_event::construct_container), 1);
+        ASSERT_EQ(hook_count(hook_event::dispatch), 3);
+        ASSERT_EQ(hook_count(hook_event::allocator_hack), BETTER_INIT_ALLOCATOR_HACK);
+        ASSERT_EQ(hook_count(hook_event::allocator_construct), (BETTER_INIT_ALLOCATOR_HACK ? 3 : 0));
+        ASSERT_EQ(hook_count(hook_event::convert_elem), (BETTER_INIT_ALLOCATOR_HACK ? 0 : 3));
+
+        // With `.emplace_back()`, short lists are expanded at compile time, so the elements are neither dispatched nor converted.
+        for (std::atomic_int &count : hook_counts)
+            count = 0;
+        std::vector<long> vec2 = INIT(1, 2L);
+        ASSERT(vec2.size() == 2);
+        ASSERT_EQ(hook_count(hook_event::construct_container), 1);
+        ASSERT_EQ(hook_count(hook_event::dispatch), (BETTER_INIT_UNROLL_LIMIT >= 2 ? 0 : 2));
+        ASSERT_EQ(hook_count(hook_event::convert_elem), 0);
+        ASSERT_EQ(hook_count(hook_event::allocator_construct), 0);
+    }
+    #endif
+
     std::cout << "OK";
     if (BETTER_INIT_ALLOCATOR_HACK)
         std::cout << "  (with allocator hack)";